@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_partition.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "ap_history.h"
+#include "ap_store.h"
+#include "ap_table.h"
+#include "gps.h"
+
+#define TAG "APHistory"
+#define HISTORY_PARTITION_LABEL "aplog"
+#define HISTORY_MAX_APS 256
+/* Room for every pair the live table can hold, so a drive's working set never evicts itself. */
+#define HISTORY_MAX_CLIENTS (MAX_APS * MAX_CLIENTS)
+#define HISTORY_COMPACT_PERIOD_MS 5000
+
+static ap_store_t history_store;
+static SemaphoreHandle_t history_mux = NULL;
+static bool history_ready = false;
+
+static bool partition_read(void *ctx, uint32_t offset, void *buf, size_t len) {
+    return esp_partition_read(ctx, offset, buf, len) == ESP_OK;
+}
+
+static bool partition_write(void *ctx, uint32_t offset, const void *buf, size_t len) {
+    return esp_partition_write(ctx, offset, buf, len) == ESP_OK;
+}
+
+static bool partition_erase(void *ctx, uint32_t offset, size_t len) {
+    return esp_partition_erase_range(ctx, offset, len) == ESP_OK;
+}
+
+/* Call with history_mux held. Once an RMC has been seen, stamps are GPS UTC. */
+static uint32_t history_now(void) {
+    int64_t timer_us = esp_timer_get_time();
+    int64_t utc_us;
+    uint32_t utc_s = gps_utc_from_timer(timer_us, &utc_us) ? (uint32_t)(utc_us / 1000000) : 0;
+    return ap_store_time(&history_store, (uint32_t)(timer_us / 1000000), utc_s);
+}
+
+/* NULL if the sighting had no fix or its track point has been overwritten. */
+static const ap_store_pos_t *resolve(gps_ref_t where, ap_store_pos_t *pos) {
+    gps_point_t at;
+    if (!gps_track_get(where, &at)) return NULL;
+    pos->lat_e7 = at.lat_e7;
+    pos->lon_e7 = at.lon_e7;
+    return pos;
+}
+
+static void ap_history_task(void *arg) {
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(HISTORY_COMPACT_PERIOD_MS));
+        xSemaphoreTake(history_mux, portMAX_DELAY);
+        if (ap_store_needs_compaction(&history_store)) {
+            ap_store_compact(&history_store);
+        }
+        xSemaphoreGive(history_mux);
+    }
+}
+
+esp_err_t ap_history_init(void) {
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                           HISTORY_PARTITION_LABEL);
+    if (!part) {
+        ESP_LOGW(TAG, "No \"%s\" partition, history disabled", HISTORY_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    ap_store_flash_t flash = {
+        .ctx = (void *)part,
+        .size = part->size - (part->size % AP_STORE_SECTOR_SIZE),
+        .read = partition_read,
+        .write = partition_write,
+        .erase = partition_erase
+    };
+    if (!ap_store_open(&history_store, &flash, HISTORY_MAX_APS, HISTORY_MAX_CLIENTS)) {
+        return ESP_FAIL;
+    }
+
+    history_mux = xSemaphoreCreateMutex();
+    history_ready = true;
+    xTaskCreate(ap_history_task, "ap_history_task", 3072, NULL, 1, NULL);
+
+    ap_store_stats_t stats;
+    ap_store_get_stats(&history_store, &stats);
+    printf("History restored: %d APs, %d clients (%u/%u sectors free)\n",
+           stats.ap_count, stats.client_count, (unsigned)stats.free_sectors, (unsigned)stats.sector_count);
+    return ESP_OK;
+}
+
+void ap_history_log_ap(const scan_result_t *ap, gps_ref_t seen_at) {
+    if (!history_ready) return;
+    uint8_t bssid[6];
+    ap_store_pos_t pos;
+    const ap_store_pos_t *at = resolve(seen_at, &pos);
+    mac_key_to_bytes(ap->bssid, bssid);
+    xSemaphoreTake(history_mux, portMAX_DELAY);
+    ap_store_log_ap(&history_store, history_now(), bssid, ap->ssid,
+                    ap->channel, (int8_t)ap->rssi, (uint8_t)ap->authmode, at);
+    xSemaphoreGive(history_mux);
+}
+
+void ap_history_log_client(mac_key_t bssid, mac_key_t client, gps_ref_t seen_at) {
+    if (!history_ready) return;
+    uint8_t bssid_bytes[6], client_bytes[6];
+    ap_store_pos_t pos;
+    const ap_store_pos_t *at = resolve(seen_at, &pos);
+    mac_key_to_bytes(bssid, bssid_bytes);
+    mac_key_to_bytes(client, client_bytes);
+    xSemaphoreTake(history_mux, portMAX_DELAY);
+    ap_store_log_client(&history_store, history_now(), bssid_bytes, client_bytes, at);
+    xSemaphoreGive(history_mux);
+}
+
+void ap_history_print_stats(void) {
+    if (!history_ready) return;
+    ap_store_stats_t stats;
+    xSemaphoreTake(history_mux, portMAX_DELAY);
+    ap_store_get_stats(&history_store, &stats);
+    xSemaphoreGive(history_mux);
+    printf("History: %d APs, %d clients, %u/%u sectors free, %u records / %u bytes written, %u erases, %u evicted\n",
+           stats.ap_count, stats.client_count, (unsigned)stats.free_sectors, (unsigned)stats.sector_count,
+           (unsigned)stats.records_written, (unsigned)stats.bytes_written, (unsigned)stats.sectors_erased,
+           (unsigned)stats.keys_evicted);
+}
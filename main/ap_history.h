@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#include "scan_snapshot.h"
+#include "gps.h"
+
+/*
+ * Persistent AP/client history kept in the "aplog" data partition.
+ * Thin ESP-IDF binding around ap_store: partition I/O, locking, and a
+ * low-priority task that compacts the log in the background.
+ *
+ * Sightings come with the track point they were heard at; a point the
+ * track ring has already overwritten is logged without a position.
+ */
+esp_err_t ap_history_init(void);
+void ap_history_log_ap(const scan_result_t *ap, gps_ref_t seen_at);
+void ap_history_log_client(mac_key_t bssid, mac_key_t client, gps_ref_t seen_at);
+void ap_history_print_stats(void);
@@ -0,0 +1,95 @@
+#include <stdlib.h>
+
+#include "ap_locate.h"
+
+#define M_PER_E7_LAT_X1E5 1112  /* 1e-7 degree of latitude is 1.112 cm */
+#define HALF_TURN_CDEG 18000    /* 180 degrees in 1/100 degree */
+
+static uint32_t rssi_weight(int8_t rssi) {
+    int shift = (rssi - AP_LOCATE_RSSI_FLOOR) / AP_LOCATE_DB_PER_DOUBLING;
+    if (shift < 0) shift = 0;
+    if (shift > AP_LOCATE_MAX_SHIFT) shift = AP_LOCATE_MAX_SHIFT;
+    return 1u << shift;
+}
+
+static uint64_t isqrt64(uint64_t v) {
+    uint64_t r = 0;
+    for (uint64_t bit = 1ull << 62; bit; bit >>= 2) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+    }
+    return r;
+}
+
+/* cos^2 of a latitude in Q16, from Bhaskara's approximation (error < 0.2%). */
+static uint64_t cos_sq_q16(int32_t lat_e7) {
+    int64_t d = lat_e7 / 100000;                /* 1/100 degree */
+    int64_t h2 = (int64_t)HALF_TURN_CDEG * HALF_TURN_CDEG;
+    int64_t cos_q16 = (h2 - 4 * d * d) * 65536 / (h2 + d * d);
+    if (cos_q16 < 0) cos_q16 = 0;
+    return (uint64_t)(cos_q16 * cos_q16) >> 16;
+}
+
+bool ap_locate_add(ap_locate_t *loc, int32_t lat_e7, int32_t lon_e7, int8_t rssi) {
+    if (loc->samples == 0) {
+        loc->anchor_lat_e7 = lat_e7;
+        loc->anchor_lon_e7 = lon_e7;
+    }
+    int64_t dlat = (int64_t)lat_e7 - loc->anchor_lat_e7;
+    int64_t dlon = (int64_t)lon_e7 - loc->anchor_lon_e7;
+    if (llabs(dlat) > AP_LOCATE_MAX_SPAN_E7 || llabs(dlon) > AP_LOCATE_MAX_SPAN_E7) {
+        if (loc->outliers < UINT16_MAX) loc->outliers++;
+        return false;
+    }
+
+    uint32_t w = rssi_weight(rssi);
+    loc->sum_lat += w * dlat;
+    loc->sum_lon += w * dlon;
+    loc->sum_lat_sq += w * dlat * dlat;
+    loc->sum_lon_sq += w * dlon * dlon;
+    loc->sum_w += w;
+    if (loc->sum_w > AP_LOCATE_MAX_WEIGHT) {
+        loc->sum_lat /= 2;
+        loc->sum_lon /= 2;
+        loc->sum_lat_sq /= 2;
+        loc->sum_lon_sq /= 2;
+        loc->sum_w /= 2;
+    }
+
+    if (loc->samples == 0 || rssi > loc->best_rssi) {
+        loc->best_rssi = rssi;
+        loc->best_lat_e7 = lat_e7;
+        loc->best_lon_e7 = lon_e7;
+    }
+    if (loc->samples < UINT16_MAX) loc->samples++;
+    return true;
+}
+
+/* Rounds to nearest, halves away from zero. */
+static int64_t div_round(int64_t num, int64_t den) {
+    return num >= 0 ? (num + den / 2) / den : -((-num + den / 2) / den);
+}
+
+bool ap_locate_estimate(const ap_locate_t *loc, ap_locate_estimate_t *out) {
+    if (loc->samples == 0 || loc->sum_w == 0) return false;
+
+    int64_t w = loc->sum_w;
+    int64_t mean_lat = div_round(loc->sum_lat, w);
+    int64_t mean_lon = div_round(loc->sum_lon, w);
+    out->lat_e7 = (int32_t)(loc->anchor_lat_e7 + mean_lat);
+    out->lon_e7 = (int32_t)(loc->anchor_lon_e7 + mean_lon);
+
+    /* Variances in (1e-7 degree)^2; a degree of longitude shrinks by cos(lat). */
+    int64_t var_lat = loc->sum_lat_sq / w - mean_lat * mean_lat;
+    int64_t var_lon = loc->sum_lon_sq / w - mean_lon * mean_lon;
+    if (var_lat < 0) var_lat = 0;
+    if (var_lon < 0) var_lon = 0;
+    uint64_t var = (uint64_t)var_lat + (((uint64_t)var_lon * cos_sq_q16(out->lat_e7)) >> 16);
+
+    out->radius_m = (uint32_t)((isqrt64(var) * M_PER_E7_LAT_X1E5 + 50000) / 100000);
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * AP position estimate from geotagged sightings: an RSSI-weighted centroid
+ * of the positions an AP was heard at, plus the position of its strongest
+ * sighting. Each sample costs O(1) integer work and the state is a few
+ * running sums, so every AP can carry one.
+ *
+ * Sums are kept as offsets from the first sample (the anchor) so squares
+ * fit in 64 bits; samples further than AP_LOCATE_MAX_SPAN_E7 from it are
+ * dropped as outliers. When the weight total passes AP_LOCATE_MAX_WEIGHT
+ * every sum is halved, which bounds them and lets old samples fade.
+ *
+ * This file has no ESP-IDF dependencies, so synthetic tracks can be run
+ * through it on a host. A zeroed ap_locate_t is empty.
+ */
+#define AP_LOCATE_RSSI_FLOOR -100       /* weight 1 at or below this */
+#define AP_LOCATE_DB_PER_DOUBLING 6     /* free space: +6 dB is about half the distance */
+#define AP_LOCATE_MAX_SHIFT 10          /* weight cap, 1 << 10 */
+#define AP_LOCATE_MAX_SPAN_E7 1000000   /* 0.1 degree, about 11 km */
+#define AP_LOCATE_MAX_WEIGHT (1u << 20)
+
+typedef struct {
+    int32_t anchor_lat_e7;
+    int32_t anchor_lon_e7;
+    int64_t sum_lat;            /* sum of w * dlat, 1e-7 degrees */
+    int64_t sum_lon;
+    int64_t sum_lat_sq;         /* sum of w * dlat^2 */
+    int64_t sum_lon_sq;
+    uint32_t sum_w;
+    int32_t best_lat_e7;
+    int32_t best_lon_e7;
+    int8_t best_rssi;
+    uint16_t samples;           /* saturating */
+    uint16_t outliers;
+} ap_locate_t;
+
+typedef struct {
+    int32_t lat_e7;
+    int32_t lon_e7;
+    uint32_t radius_m;          /* weighted RMS distance of the samples from the estimate */
+} ap_locate_estimate_t;
+
+/* Adds one sighting at the given position; false if it was dropped as an outlier. */
+bool ap_locate_add(ap_locate_t *loc, int32_t lat_e7, int32_t lon_e7, int8_t rssi);
+
+/* False until the first sample. */
+bool ap_locate_estimate(const ap_locate_t *loc, ap_locate_estimate_t *out);
@@ -0,0 +1,540 @@
+#include <string.h>
+#include <stdlib.h>
+
+#include "ap_store.h"
+#include "mac_key.h"
+
+#define SECTOR_MAGIC 0x32475041u      /* "APG2"; older layouts are erased at open */
+#define SECTOR_HDR_SIZE 16
+#define REC_HDR_SIZE 4
+#define REC_ERASED 0xFF
+#define REC_AP 0x01
+#define REC_CLIENT 0x02
+#define AP_PAYLOAD_FIXED 28
+#define CLIENT_PAYLOAD_SIZE 30
+#define AP_POS_OFFSET 20
+#define CLIENT_POS_OFFSET 22
+#define POS_NONE INT32_MIN           /* lat_e7 of a sighting without a fix */
+#define MAX_RECORD_SIZE (REC_HDR_SIZE + AP_PAYLOAD_FIXED + 32)
+
+/*
+ * Sector:  magic u32 | seq u32 | ~seq u32 | 0xFFFFFFFF | records...
+ * Record:  type u8 | len u8 | crc16 u16 | payload[len]
+ * AP:      last_seen u32 | first_seen u32 | sightings u16 | bssid[6] |
+ *          channel u8 | rssi i8 | authmode u8 | ssid_len u8 |
+ *          lat_e7 i32 | lon_e7 i32 | ssid[ssid_len]
+ * Client:  last_seen u32 | first_seen u32 | sightings u16 | bssid[6] | client[6] |
+ *          lat_e7 i32 | lon_e7 i32
+ * lat_e7 is INT32_MIN for a sighting without a fix.
+ * All integers little-endian. Erased flash reads 0xFF, which ends a sector.
+ */
+
+static uint8_t sector_buf[AP_STORE_SECTOR_SIZE];
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t crc16_ccitt(uint16_t crc, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static uint16_t record_crc(const uint8_t *rec) {
+    uint16_t crc = crc16_ccitt(0xFFFF, rec, 2);
+    return crc16_ccitt(crc, rec + REC_HDR_SIZE, rec[1]);
+}
+
+static uint32_t free_sectors(const ap_store_t *st) {
+    uint32_t n = 0;
+    for (uint32_t s = 0; s < st->sector_count; s++) {
+        if (st->sector_seq[s] == 0) n++;
+    }
+    return n;
+}
+
+static uint32_t ap_hash(const uint8_t *bssid) {
+    return mac_key_hash(mac_key_from_bytes(bssid));
+}
+
+static uint32_t client_hash(const uint8_t *bssid, const uint8_t *client) {
+    return mac_key_hash(mac_key_from_bytes(client) ^ (mac_key_from_bytes(bssid) * 0xFF51AFD7ED558CCDull));
+}
+
+static uint32_t ap_entry_hash(const ap_store_t *st, int entry) {
+    return ap_hash(st->aps[entry].bssid);
+}
+
+static uint32_t client_entry_hash(const ap_store_t *st, int entry) {
+    return client_hash(st->clients[entry].bssid, st->clients[entry].client);
+}
+
+static bool index_alloc(ap_store_index_t *idx, int capacity) {
+    int bits = 1;
+    while ((1 << bits) < 2 * capacity) bits++;
+    idx->mask = (1u << bits) - 1;
+    idx->shift = 32 - bits;
+    idx->buckets = calloc(idx->mask + 1, sizeof(uint16_t));
+    return idx->buckets != NULL;
+}
+
+static void index_insert(ap_store_index_t *idx, uint32_t hash, int entry) {
+    uint32_t i = hash >> idx->shift;
+    while (idx->buckets[i]) i = (i + 1) & idx->mask;
+    idx->buckets[i] = entry + 1;
+}
+
+/* Backward-shift delete, as in ap_table. */
+static void index_remove(const ap_store_t *st, ap_store_index_t *idx, uint32_t hash, int entry,
+                         uint32_t (*entry_hash)(const ap_store_t *, int)) {
+    uint32_t i = hash >> idx->shift;
+    while (idx->buckets[i] != entry + 1) i = (i + 1) & idx->mask;
+
+    for (uint32_t j = (i + 1) & idx->mask; idx->buckets[j]; j = (j + 1) & idx->mask) {
+        uint32_t home = entry_hash(st, idx->buckets[j] - 1) >> idx->shift;
+        if (((j - home) & idx->mask) >= ((j - i) & idx->mask)) {
+            idx->buckets[i] = idx->buckets[j];
+            i = j;
+        }
+    }
+    idx->buckets[i] = 0;
+}
+
+static ap_store_ap_t *find_ap(const ap_store_t *st, const uint8_t *bssid) {
+    const ap_store_index_t *idx = &st->ap_index;
+    for (uint32_t i = ap_hash(bssid) >> idx->shift; idx->buckets[i]; i = (i + 1) & idx->mask) {
+        ap_store_ap_t *ap = &st->aps[idx->buckets[i] - 1];
+        if (memcmp(ap->bssid, bssid, 6) == 0) return ap;
+    }
+    return NULL;
+}
+
+static ap_store_client_t *find_client(const ap_store_t *st, const uint8_t *bssid, const uint8_t *client) {
+    const ap_store_index_t *idx = &st->client_index;
+    for (uint32_t i = client_hash(bssid, client) >> idx->shift; idx->buckets[i]; i = (i + 1) & idx->mask) {
+        ap_store_client_t *c = &st->clients[idx->buckets[i] - 1];
+        if (memcmp(c->client, client, 6) == 0 && memcmp(c->bssid, bssid, 6) == 0) return c;
+    }
+    return NULL;
+}
+
+/* Indexes a new key; if full, the clock hand evicts the first key not sighted since its last pass. */
+static ap_store_ap_t *add_ap(ap_store_t *st, const uint8_t *bssid) {
+    int entry;
+    if (st->ap_count < st->ap_capacity) {
+        entry = st->ap_count++;
+    } else {
+        while (st->aps[st->ap_hand].referenced) {
+            st->aps[st->ap_hand].referenced = false;
+            st->ap_hand = (st->ap_hand + 1) % st->ap_count;
+        }
+        entry = st->ap_hand;
+        st->ap_hand = (st->ap_hand + 1) % st->ap_count;
+        index_remove(st, &st->ap_index, ap_entry_hash(st, entry), entry, ap_entry_hash);
+        st->keys_evicted++;
+    }
+    memcpy(st->aps[entry].bssid, bssid, 6);
+    st->aps[entry].referenced = false;
+    index_insert(&st->ap_index, ap_hash(bssid), entry);
+    return &st->aps[entry];
+}
+
+static ap_store_client_t *add_client(ap_store_t *st, const uint8_t *bssid, const uint8_t *client) {
+    int entry;
+    if (st->client_count < st->client_capacity) {
+        entry = st->client_count++;
+    } else {
+        while (st->clients[st->client_hand].referenced) {
+            st->clients[st->client_hand].referenced = false;
+            st->client_hand = (st->client_hand + 1) % st->client_count;
+        }
+        entry = st->client_hand;
+        st->client_hand = (st->client_hand + 1) % st->client_count;
+        index_remove(st, &st->client_index, client_entry_hash(st, entry), entry, client_entry_hash);
+        st->keys_evicted++;
+    }
+    memcpy(st->clients[entry].bssid, bssid, 6);
+    memcpy(st->clients[entry].client, client, 6);
+    st->clients[entry].referenced = false;
+    index_insert(&st->client_index, client_hash(bssid, client), entry);
+    return &st->clients[entry];
+}
+
+/* Makes `rec` (located at `loc`) the newest state of its key. */
+static void index_record(ap_store_t *st, const uint8_t *rec, uint32_t loc) {
+    const uint8_t *p = rec + REC_HDR_SIZE;
+    if (rec[0] == REC_AP) {
+        ap_store_ap_t *ap = find_ap(st, p + 10);
+        if (ap) ap->referenced = true;
+        else ap = add_ap(st, p + 10);
+        ap->last_seen = get_u32(p);
+        ap->first_seen = get_u32(p + 4);
+        ap->sightings = get_u16(p + 8);
+        ap->channel = p[16];
+        ap->rssi = (int8_t)p[17];
+        ap->authmode = p[18];
+        ap->loc = loc;
+        ap->has_pos = (int32_t)get_u32(p + AP_POS_OFFSET) != POS_NONE;
+    } else if (rec[0] == REC_CLIENT) {
+        ap_store_client_t *c = find_client(st, p + 10, p + 16);
+        if (c) c->referenced = true;
+        else c = add_client(st, p + 10, p + 16);
+        c->last_seen = get_u32(p);
+        c->first_seen = get_u32(p + 4);
+        c->sightings = get_u16(p + 8);
+        c->loc = loc;
+        c->has_pos = (int32_t)get_u32(p + CLIENT_POS_OFFSET) != POS_NONE;
+    }
+}
+
+static bool index_is_live(const ap_store_t *st, const uint8_t *rec, uint32_t loc) {
+    const uint8_t *p = rec + REC_HDR_SIZE;
+    if (rec[0] == REC_AP) {
+        const ap_store_ap_t *ap = find_ap(st, p + 10);
+        return ap && ap->loc == loc;
+    }
+    if (rec[0] == REC_CLIENT) {
+        const ap_store_client_t *c = find_client(st, p + 10, p + 16);
+        return c && c->loc == loc;
+    }
+    return false;
+}
+
+/* Length of the valid record at `off` in sector_buf, 0 at the end of data, -1 if corrupt. */
+static int parse_record(uint32_t off) {
+    if (off + REC_HDR_SIZE > AP_STORE_SECTOR_SIZE) return 0;
+    const uint8_t *rec = &sector_buf[off];
+    if (rec[0] == REC_ERASED) return 0;
+    if (rec[0] != REC_AP && rec[0] != REC_CLIENT) return -1;
+    if (off + REC_HDR_SIZE + rec[1] > AP_STORE_SECTOR_SIZE) return -1;
+    if (rec[0] == REC_AP && (rec[1] < AP_PAYLOAD_FIXED || rec[1] != AP_PAYLOAD_FIXED + rec[REC_HDR_SIZE + 19])) return -1;
+    if (rec[0] == REC_CLIENT && rec[1] != CLIENT_PAYLOAD_SIZE) return -1;
+    if (get_u16(rec + 2) != record_crc(rec)) return -1;
+    return REC_HDR_SIZE + rec[1];
+}
+
+static bool read_sector(ap_store_t *st, uint32_t sector) {
+    return st->flash.read(st->flash.ctx, sector * AP_STORE_SECTOR_SIZE, sector_buf, AP_STORE_SECTOR_SIZE);
+}
+
+static bool erase_sector(ap_store_t *st, uint32_t sector) {
+    if (!st->flash.erase(st->flash.ctx, sector * AP_STORE_SECTOR_SIZE, AP_STORE_SECTOR_SIZE)) return false;
+    st->sector_seq[sector] = 0;
+    st->sectors_erased++;
+    return true;
+}
+
+static bool open_next_sector(ap_store_t *st) {
+    uint32_t next = (st->head_sector + 1) % st->sector_count;
+    if (st->sector_seq[next] != 0) return false;
+
+    uint8_t hdr[SECTOR_HDR_SIZE];
+    uint32_t seq = st->head_seq + 1;
+    put_u32(hdr, SECTOR_MAGIC);
+    put_u32(hdr + 4, seq);
+    put_u32(hdr + 8, ~seq);
+    put_u32(hdr + 12, 0xFFFFFFFFu);
+    if (!st->flash.write(st->flash.ctx, next * AP_STORE_SECTOR_SIZE, hdr, sizeof(hdr))) return false;
+
+    st->sector_seq[next] = seq;
+    st->head_seq = seq;
+    st->head_sector = next;
+    st->head_offset = SECTOR_HDR_SIZE;
+    return true;
+}
+
+static bool append_record(ap_store_t *st, const uint8_t *rec, bool compacting, uint32_t *loc) {
+    uint32_t total = REC_HDR_SIZE + rec[1];
+    if (st->head_offset + total > AP_STORE_SECTOR_SIZE) {
+        /* Keep one erased sector in reserve for compaction's own copies. */
+        for (uint32_t i = 0; !compacting && free_sectors(st) < 2 && i < st->sector_count; i++) {
+            if (!ap_store_compact(st)) break;
+        }
+        if (!compacting && free_sectors(st) < 2) return false;
+        if (!open_next_sector(st)) return false;
+    }
+
+    *loc = st->head_sector * AP_STORE_SECTOR_SIZE + st->head_offset;
+    if (!st->flash.write(st->flash.ctx, *loc, rec, total)) {
+        /* Whatever landed is unreadable garbage now; never write past it. */
+        st->head_offset = AP_STORE_SECTOR_SIZE;
+        return false;
+    }
+    st->head_offset += total;
+    st->records_written++;
+    st->bytes_written += total;
+    return true;
+}
+
+static bool write_record(ap_store_t *st, uint8_t *rec) {
+    put_u16(rec + 2, record_crc(rec));
+    uint32_t loc;
+    if (!append_record(st, rec, false, &loc)) return false;
+    index_record(st, rec, loc);
+    return true;
+}
+
+static void replay_sector(ap_store_t *st, uint32_t sector, bool is_head) {
+    uint32_t off = SECTOR_HDR_SIZE;
+    while (1) {
+        int len = parse_record(off);
+        if (len == 0) break;
+        if (len < 0) {
+            st->records_dropped++;
+            off = AP_STORE_SECTOR_SIZE;
+            break;
+        }
+        const uint8_t *rec = &sector_buf[off];
+        uint32_t stamp = get_u32(rec + REC_HDR_SIZE);
+        if (stamp >= st->clock_base) st->clock_base = stamp + 1;
+        index_record(st, rec, sector * AP_STORE_SECTOR_SIZE + off);
+        off += len;
+    }
+    if (is_head) st->head_offset = off;
+}
+
+bool ap_store_open(ap_store_t *st, const ap_store_flash_t *flash, int max_aps, int max_clients) {
+    memset(st, 0, sizeof(*st));
+    st->flash = *flash;
+    st->sector_count = flash->size / AP_STORE_SECTOR_SIZE;
+    if (st->sector_count < 3 || max_aps > AP_STORE_MAX_KEYS || max_clients > AP_STORE_MAX_KEYS) return false;
+
+    st->sector_seq = calloc(st->sector_count, sizeof(uint32_t));
+    st->aps = calloc(max_aps, sizeof(ap_store_ap_t));
+    st->clients = calloc(max_clients, sizeof(ap_store_client_t));
+    if (!st->sector_seq || !st->aps || !st->clients ||
+        !index_alloc(&st->ap_index, max_aps) || !index_alloc(&st->client_index, max_clients)) {
+        ap_store_close(st);
+        return false;
+    }
+    st->ap_capacity = max_aps;
+    st->client_capacity = max_clients;
+
+    uint32_t used = 0;
+    for (uint32_t s = 0; s < st->sector_count; s++) {
+        uint8_t hdr[SECTOR_HDR_SIZE];
+        if (!st->flash.read(st->flash.ctx, s * AP_STORE_SECTOR_SIZE, hdr, sizeof(hdr))) {
+            ap_store_close(st);
+            return false;
+        }
+        uint32_t seq = get_u32(hdr + 4);
+        if (get_u32(hdr) == SECTOR_MAGIC && seq == ~get_u32(hdr + 8) && seq != 0) {
+            st->sector_seq[s] = seq;
+            used++;
+        } else if (get_u32(hdr) != 0xFFFFFFFFu) {
+            /* Interrupted header write or foreign data. */
+            erase_sector(st, s);
+        }
+    }
+
+    /* Replay oldest to newest so later records win. */
+    uint32_t prev_seq = 0;
+    for (uint32_t n = 0; n < used; n++) {
+        uint32_t next = 0, next_seq = UINT32_MAX;
+        for (uint32_t s = 0; s < st->sector_count; s++) {
+            if (st->sector_seq[s] > prev_seq && st->sector_seq[s] < next_seq) {
+                next = s;
+                next_seq = st->sector_seq[s];
+            }
+        }
+        bool is_head = (n == used - 1);
+        if (read_sector(st, next)) {
+            replay_sector(st, next, is_head);
+        } else if (is_head) {
+            st->head_offset = AP_STORE_SECTOR_SIZE;
+        }
+        if (is_head) {
+            st->head_sector = next;
+            st->head_seq = next_seq;
+        }
+        prev_seq = next_seq;
+    }
+
+    if (used == 0) {
+        st->head_sector = st->sector_count - 1;
+        return open_next_sector(st);
+    }
+    return true;
+}
+
+void ap_store_close(ap_store_t *st) {
+    free(st->sector_seq);
+    free(st->aps);
+    free(st->clients);
+    free(st->ap_index.buckets);
+    free(st->client_index.buckets);
+    st->sector_seq = NULL;
+    st->aps = NULL;
+    st->clients = NULL;
+    st->ap_index.buckets = NULL;
+    st->client_index.buckets = NULL;
+}
+
+uint32_t ap_store_time(ap_store_t *st, uint32_t uptime_s, uint32_t utc_s) {
+    uint32_t now = st->clock_base + uptime_s;
+    if (utc_s > now) {
+        st->clock_base += utc_s - now;
+        now = utc_s;
+    }
+    return now;
+}
+
+static bool is_stale(uint32_t now, uint32_t last_seen) {
+    int32_t age = (int32_t)(now - last_seen);
+    return age < 0 || age >= AP_STORE_REFRESH_SEC;
+}
+
+static void put_pos(uint8_t *p, const ap_store_pos_t *at) {
+    put_u32(p, at ? (uint32_t)at->lat_e7 : (uint32_t)POS_NONE);
+    put_u32(p + 4, at ? (uint32_t)at->lon_e7 : 0);
+}
+
+bool ap_store_log_ap(ap_store_t *st, uint32_t now, const uint8_t bssid[6], const char *ssid,
+                     uint8_t channel, int8_t rssi, uint8_t authmode, const ap_store_pos_t *at) {
+    ap_store_ap_t *ap = find_ap(st, bssid);
+    if (ap && ap->channel == channel && ap->authmode == authmode && (ap->has_pos || !at) &&
+        !is_stale(now, ap->last_seen)) {
+        ap->referenced = true;
+        return true;
+    }
+
+    size_t ssid_len = strnlen(ssid, 32);
+    uint8_t rec[MAX_RECORD_SIZE];
+    uint8_t *p = rec + REC_HDR_SIZE;
+    rec[0] = REC_AP;
+    rec[1] = AP_PAYLOAD_FIXED + ssid_len;
+    put_u32(p, now);
+    put_u32(p + 4, ap ? ap->first_seen : now);
+    put_u16(p + 8, ap && ap->sightings < UINT16_MAX ? ap->sightings + 1 : (ap ? UINT16_MAX : 1));
+    memcpy(p + 10, bssid, 6);
+    p[16] = channel;
+    p[17] = (uint8_t)rssi;
+    p[18] = authmode;
+    p[19] = ssid_len;
+    put_pos(p + AP_POS_OFFSET, at);
+    memcpy(p + AP_PAYLOAD_FIXED, ssid, ssid_len);
+    return write_record(st, rec);
+}
+
+bool ap_store_log_client(ap_store_t *st, uint32_t now, const uint8_t bssid[6], const uint8_t client[6],
+                         const ap_store_pos_t *at) {
+    ap_store_client_t *c = find_client(st, bssid, client);
+    if (c && (c->has_pos || !at) && !is_stale(now, c->last_seen)) {
+        c->referenced = true;
+        return true;
+    }
+
+    uint8_t rec[REC_HDR_SIZE + CLIENT_PAYLOAD_SIZE];
+    uint8_t *p = rec + REC_HDR_SIZE;
+    rec[0] = REC_CLIENT;
+    rec[1] = CLIENT_PAYLOAD_SIZE;
+    put_u32(p, now);
+    put_u32(p + 4, c ? c->first_seen : now);
+    put_u16(p + 8, c && c->sightings < UINT16_MAX ? c->sightings + 1 : (c ? UINT16_MAX : 1));
+    memcpy(p + 10, bssid, 6);
+    memcpy(p + 16, client, 6);
+    put_pos(p + CLIENT_POS_OFFSET, at);
+    return write_record(st, rec);
+}
+
+const ap_store_ap_t *ap_store_find_ap(const ap_store_t *st, const uint8_t bssid[6]) {
+    return find_ap(st, bssid);
+}
+
+const ap_store_client_t *ap_store_find_client(const ap_store_t *st, const uint8_t bssid[6],
+                                              const uint8_t client[6]) {
+    return find_client(st, bssid, client);
+}
+
+static bool read_pos(const ap_store_t *st, uint32_t loc, uint8_t type, uint32_t offset, ap_store_pos_t *out) {
+    uint8_t rec[REC_HDR_SIZE];
+    uint8_t pos[8];
+    if (!st->flash.read(st->flash.ctx, loc, rec, sizeof(rec)) || rec[0] != type ||
+        !st->flash.read(st->flash.ctx, loc + REC_HDR_SIZE + offset, pos, sizeof(pos))) {
+        return false;
+    }
+    out->lat_e7 = (int32_t)get_u32(pos);
+    out->lon_e7 = (int32_t)get_u32(pos + 4);
+    return out->lat_e7 != POS_NONE;
+}
+
+bool ap_store_read_ap_pos(const ap_store_t *st, const ap_store_ap_t *ap, ap_store_pos_t *out) {
+    return read_pos(st, ap->loc, REC_AP, AP_POS_OFFSET, out);
+}
+
+bool ap_store_read_client_pos(const ap_store_t *st, const ap_store_client_t *c, ap_store_pos_t *out) {
+    return read_pos(st, c->loc, REC_CLIENT, CLIENT_POS_OFFSET, out);
+}
+
+bool ap_store_read_ssid(const ap_store_t *st, const ap_store_ap_t *ap, char *ssid, size_t len) {
+    uint8_t rec[MAX_RECORD_SIZE];
+    if (len == 0 || !st->flash.read(st->flash.ctx, ap->loc, rec, REC_HDR_SIZE + AP_PAYLOAD_FIXED)) return false;
+    size_t ssid_len = rec[REC_HDR_SIZE + 19];
+    if (rec[0] != REC_AP || ssid_len > 32) return false;
+    if (!st->flash.read(st->flash.ctx, ap->loc + REC_HDR_SIZE + AP_PAYLOAD_FIXED, ssid, ssid_len < len ? ssid_len : len - 1)) {
+        return false;
+    }
+    ssid[ssid_len < len ? ssid_len : len - 1] = '\0';
+    return true;
+}
+
+bool ap_store_needs_compaction(const ap_store_t *st) {
+    return free_sectors(st) < AP_STORE_COMPACT_FREE_SECTORS;
+}
+
+bool ap_store_compact(ap_store_t *st) {
+    uint32_t oldest = st->sector_count, oldest_seq = UINT32_MAX;
+    for (uint32_t s = 0; s < st->sector_count; s++) {
+        if (s != st->head_sector && st->sector_seq[s] != 0 && st->sector_seq[s] < oldest_seq) {
+            oldest = s;
+            oldest_seq = st->sector_seq[s];
+        }
+    }
+    if (oldest == st->sector_count || !read_sector(st, oldest)) return false;
+
+    uint32_t off = SECTOR_HDR_SIZE;
+    int len;
+    while ((len = parse_record(off)) > 0) {
+        uint32_t loc = oldest * AP_STORE_SECTOR_SIZE + off;
+        if (index_is_live(st, &sector_buf[off], loc)) {
+            uint32_t new_loc;
+            if (!append_record(st, &sector_buf[off], true, &new_loc)) return false;
+            index_record(st, &sector_buf[off], new_loc);
+        }
+        off += len;
+    }
+    return erase_sector(st, oldest);
+}
+
+void ap_store_get_stats(const ap_store_t *st, ap_store_stats_t *out) {
+    out->ap_count = st->ap_count;
+    out->client_count = st->client_count;
+    out->free_sectors = free_sectors(st);
+    out->sector_count = st->sector_count;
+    out->records_written = st->records_written;
+    out->bytes_written = st->bytes_written;
+    out->sectors_erased = st->sectors_erased;
+    out->records_dropped = st->records_dropped;
+    out->keys_evicted = st->keys_evicted;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Append-only, log-structured store of AP and client sightings.
+ *
+ * The backing region is split into sectors that are filled in ring order.
+ * Every record carries the full, cumulative state of its key (first/last
+ * seen, sighting count) and the position of the sighting it logs, so the
+ * newest record for a key is authoritative and older ones become garbage. A RAM index of the newest record per key is
+ * rebuilt by replaying the log at open, with open-addressed hash lookups so
+ * replay is O(records); compaction copies the still-live records out of the
+ * oldest sector and erases it.
+ *
+ * A full index makes room with a clock hand: a key sighted since the hand
+ * last passed it gets a second chance, so eviction is amortised O(1) and
+ * picks keys that have gone quiet. An evicted key's records become garbage,
+ * so size the index for the working set.
+ *
+ * Timestamps come from the store's own clock (ap_store_time), which resumes
+ * after the newest replayed stamp, so refresh ages stay right across
+ * reboots without a wall clock.
+ *
+ * This file has no ESP-IDF dependencies: the flash is reached only through
+ * ap_store_flash_t, so a file-backed partition image can stand in on a host.
+ * A store is not thread-safe (and shares one sector buffer); callers serialise.
+ */
+
+#define AP_STORE_SECTOR_SIZE 4096
+#define AP_STORE_REFRESH_SEC 600      /* re-log an unchanged key at most this often */
+#define AP_STORE_COMPACT_FREE_SECTORS 8 /* background compaction below this many */
+#define AP_STORE_MAX_KEYS 32767
+
+/* Where a sighting was heard; log calls take NULL without a fix. */
+typedef struct {
+    int32_t lat_e7;             /* 1e-7 degrees */
+    int32_t lon_e7;
+} ap_store_pos_t;
+
+typedef struct {
+    void *ctx;
+    uint32_t size;              /* bytes, a multiple of AP_STORE_SECTOR_SIZE */
+    bool (*read)(void *ctx, uint32_t offset, void *buf, size_t len);
+    bool (*write)(void *ctx, uint32_t offset, const void *buf, size_t len);
+    bool (*erase)(void *ctx, uint32_t offset, size_t len);
+} ap_store_flash_t;
+
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t channel;
+    int8_t rssi;
+    uint8_t authmode;
+    uint16_t sightings;
+    uint32_t first_seen;
+    uint32_t last_seen;
+    uint32_t loc;               /* flash offset of the newest record */
+    bool referenced;            /* sighted since the clock hand passed */
+    bool has_pos;               /* the newest record carries a position */
+} ap_store_ap_t;
+
+typedef struct {
+    uint8_t client[6];
+    uint8_t bssid[6];
+    uint16_t sightings;
+    uint32_t first_seen;
+    uint32_t last_seen;
+    uint32_t loc;
+    bool referenced;
+    bool has_pos;
+} ap_store_client_t;
+
+typedef struct {
+    uint16_t *buckets;          /* entry + 1, 0 = empty; at most half full */
+    uint32_t mask;
+    int shift;
+} ap_store_index_t;
+
+typedef struct {
+    ap_store_flash_t flash;
+    uint32_t sector_count;
+    uint32_t head_sector;
+    uint32_t head_offset;
+    uint32_t head_seq;
+    uint32_t *sector_seq;       /* 0 = erased */
+
+    ap_store_ap_t *aps;
+    int ap_count;
+    int ap_capacity;
+    ap_store_client_t *clients;
+    int client_count;
+    int client_capacity;
+    ap_store_index_t ap_index;
+    ap_store_index_t client_index;
+    int ap_hand;                /* eviction clock positions */
+    int client_hand;
+    uint32_t clock_base;        /* store time at uptime 0 of this boot */
+
+    uint32_t records_written;
+    uint32_t bytes_written;
+    uint32_t sectors_erased;
+    uint32_t records_dropped;   /* torn or corrupt records skipped at replay */
+    uint32_t keys_evicted;
+} ap_store_t;
+
+typedef struct {
+    int ap_count;
+    int client_count;
+    uint32_t free_sectors;
+    uint32_t sector_count;
+    uint32_t records_written;
+    uint32_t bytes_written;
+    uint32_t sectors_erased;
+    uint32_t records_dropped;
+    uint32_t keys_evicted;
+} ap_store_stats_t;
+
+/* max_aps and max_clients are at most AP_STORE_MAX_KEYS. */
+bool ap_store_open(ap_store_t *st, const ap_store_flash_t *flash, int max_aps, int max_clients);
+void ap_store_close(ap_store_t *st);
+
+/*
+ * Current store time in seconds: this boot's uptime on top of the newest
+ * stamp in the log, pulled forward to `utc_s` (0 = unknown) once wall time
+ * is known. Never goes backwards, within a boot or across reboots.
+ */
+uint32_t ap_store_time(ap_store_t *st, uint32_t uptime_s, uint32_t utc_s);
+
+/*
+ * Record a sighting at store time `now`, heard at `at` (NULL = no fix).
+ * Only touches flash if the key is new, changed, stale, or gets its first
+ * position; a moving position alone waits for the refresh.
+ */
+bool ap_store_log_ap(ap_store_t *st, uint32_t now, const uint8_t bssid[6], const char *ssid,
+                     uint8_t channel, int8_t rssi, uint8_t authmode, const ap_store_pos_t *at);
+bool ap_store_log_client(ap_store_t *st, uint32_t now, const uint8_t bssid[6], const uint8_t client[6],
+                         const ap_store_pos_t *at);
+
+const ap_store_ap_t *ap_store_find_ap(const ap_store_t *st, const uint8_t bssid[6]);
+const ap_store_client_t *ap_store_find_client(const ap_store_t *st, const uint8_t bssid[6],
+                                              const uint8_t client[6]);
+bool ap_store_read_ssid(const ap_store_t *st, const ap_store_ap_t *ap, char *ssid, size_t len);
+/* Position of the newest record; false if it was logged without a fix. */
+bool ap_store_read_ap_pos(const ap_store_t *st, const ap_store_ap_t *ap, ap_store_pos_t *out);
+bool ap_store_read_client_pos(const ap_store_t *st, const ap_store_client_t *c, ap_store_pos_t *out);
+
+bool ap_store_needs_compaction(const ap_store_t *st);
+/* Reclaims the oldest sector. Returns false if there was nothing to do. */
+bool ap_store_compact(ap_store_t *st);
+
+void ap_store_get_stats(const ap_store_t *st, ap_store_stats_t *out);
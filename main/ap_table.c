@@ -0,0 +1,348 @@
+#include <string.h>
+#include <stdlib.h>
+#include "esp_heap_caps.h"
+
+#include "ap_table.h"
+#include "roam.h"
+#include "ssid_pool.h"
+#include "scan_plan.h"
+
+ap_hot_t ap_hot;
+
+static ap_cold_t **pool_blocks = NULL;
+static int pool_block_count = 0;
+static int pool_capacity = 0;
+static int table_max_aps = 0;
+
+static uint16_t *free_slots = NULL;     /* stack of unused slot ids */
+static int free_count = 0;
+static uint16_t *active_slots = NULL;   /* occupied slots in insertion order */
+static int active_count = 0;
+static int peak_count = 0;
+static bool update_reset_clients = false;
+static uint32_t table_generation = 0;
+static uint32_t retired_count = 0;
+
+static uint16_t *bssid_index = NULL;    /* slot + 1 per bucket, 0 = empty */
+static uint32_t index_mask = 0;
+static int index_shift = 0;
+
+esp_err_t ap_table_init(int max_aps) {
+    int blocks = (max_aps + AP_POOL_BLOCK - 1) / AP_POOL_BLOCK;
+    table_max_aps = blocks * AP_POOL_BLOCK;
+    pool_blocks = calloc(blocks, sizeof(ap_cold_t *));
+    free_slots = calloc(table_max_aps, sizeof(uint16_t));
+    active_slots = calloc(table_max_aps, sizeof(uint16_t));
+    ap_hot.bssid = calloc(table_max_aps, sizeof(mac_key_t));
+    ap_hot.rssi = calloc(table_max_aps, sizeof(int8_t));
+    ap_hot.channel = calloc(table_max_aps, sizeof(uint8_t));
+    ap_hot.client_count = calloc(table_max_aps, sizeof(uint16_t));
+    ap_hot.authmode = calloc(table_max_aps, sizeof(uint16_t));
+
+    /* At most half full, so every probe run ends at an empty bucket. */
+    int index_bits = 1;
+    while ((1 << index_bits) < 2 * table_max_aps) index_bits++;
+    index_mask = (1u << index_bits) - 1;
+    index_shift = 32 - index_bits;
+    bssid_index = calloc(index_mask + 1, sizeof(uint16_t));
+
+    if (!pool_blocks || !free_slots || !active_slots || !ap_hot.bssid || !ap_hot.rssi ||
+        !ap_hot.channel || !ap_hot.client_count || !ap_hot.authmode || !bssid_index) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (!ssid_pool_init(table_max_aps)) return ESP_ERR_NO_MEM;
+    return ap_table_reserve(AP_POOL_BLOCK) > 0 ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+int ap_table_reserve(int wanted) {
+    while (pool_capacity < wanted && pool_capacity < table_max_aps) {
+        size_t block_bytes = AP_POOL_BLOCK * sizeof(ap_cold_t);
+        if (heap_caps_get_free_size(MALLOC_CAP_DEFAULT) < block_bytes + AP_TABLE_HEAP_RESERVE) break;
+        ap_cold_t *block = heap_caps_calloc(AP_POOL_BLOCK, sizeof(ap_cold_t), MALLOC_CAP_DEFAULT);
+        if (!block) break;
+
+        pool_blocks[pool_block_count++] = block;
+        /* Push in reverse so low slot ids are handed out first. */
+        for (int i = AP_POOL_BLOCK - 1; i >= 0; i--) {
+            free_slots[free_count++] = pool_capacity + i;
+        }
+        pool_capacity += AP_POOL_BLOCK;
+    }
+    return pool_capacity;
+}
+
+ap_cold_t *ap_table_cold(int slot) {
+    return &pool_blocks[slot / AP_POOL_BLOCK][slot % AP_POOL_BLOCK];
+}
+
+int ap_table_count(void) {
+    return active_count;
+}
+
+uint32_t ap_table_generation(void) {
+    return table_generation;
+}
+
+int ap_table_slot_at(int index) {
+    return active_slots[index];
+}
+
+static int compare_order(const void *a, const void *b) {
+    const ap_order_t *ra = (const ap_order_t *)a;
+    const ap_order_t *rb = (const ap_order_t *)b;
+    if (ra->rssi != rb->rssi) return rb->rssi - ra->rssi;
+    return ra->slot - rb->slot;
+}
+
+void ap_table_order(ap_order_t *order, int n, bool by_rssi) {
+    for (int i = 0; i < n; i++) {
+        order[i].slot = active_slots[i];
+        order[i].rssi = ap_hot.rssi[order[i].slot];
+    }
+    if (by_rssi && n > 1) {
+        qsort(order, n, sizeof(ap_order_t), compare_order);
+    }
+}
+
+/* Linear-probe start slot; the top bits of the hash, since its low bits mix least. */
+static inline uint32_t index_home(mac_key_t bssid) {
+    return mac_key_hash(bssid) >> index_shift;
+}
+
+static void index_insert(int slot) {
+    uint32_t i = index_home(ap_hot.bssid[slot]);
+    while (bssid_index[i]) i = (i + 1) & index_mask;
+    bssid_index[i] = slot + 1;
+}
+
+/* Backward-shift delete: keeps probe runs unbroken without tombstones. */
+static void index_remove(int slot) {
+    uint32_t i = index_home(ap_hot.bssid[slot]);
+    while (bssid_index[i] != slot + 1) i = (i + 1) & index_mask;
+
+    for (uint32_t j = (i + 1) & index_mask; bssid_index[j]; j = (j + 1) & index_mask) {
+        uint32_t home = index_home(ap_hot.bssid[bssid_index[j] - 1]);
+        if (((j - home) & index_mask) >= ((j - i) & index_mask)) {
+            bssid_index[i] = bssid_index[j];
+            i = j;
+        }
+    }
+    bssid_index[i] = 0;
+}
+
+int ap_table_find(mac_key_t bssid) {
+    for (uint32_t i = index_home(bssid); bssid_index[i]; i = (i + 1) & index_mask) {
+        int slot = bssid_index[i] - 1;
+        if (mac_key_eq(ap_hot.bssid[slot], bssid)) return slot;
+    }
+    return -1;
+}
+
+void ap_table_get_channels(channel_mask_t *out) {
+    channel_mask_clear(out);
+    for (int i = 0; i < active_count; i++) {
+        channel_mask_set(out, ap_hot.channel[active_slots[i]]);
+    }
+}
+
+static int alloc_slot(void) {
+    if (free_count == 0) return -1;
+    int slot = free_slots[--free_count];
+    ap_cold_t *cold = ap_table_cold(slot);
+    memset(cold, 0, sizeof(*cold));
+    cold->ssid_id = SSID_NONE;
+    ap_hot.client_count[slot] = 0;
+    active_slots[active_count++] = slot;
+    if (active_count > peak_count) peak_count = active_count;
+    table_generation++;
+    return slot;
+}
+
+void ap_table_begin_update(bool reset_clients) {
+    update_reset_clients = reset_clients;
+    for (int i = 0; i < active_count; i++) {
+        ap_table_cold(active_slots[i])->seen = false;
+    }
+}
+
+void ap_table_merge(const wifi_ap_record_t *records, int count, gps_ref_t where) {
+    for (int r = 0; r < count; r++) {
+        mac_key_t bssid = mac_key_from_bytes(records[r].bssid);
+        if (bssid == MAC_KEY_NONE) continue;
+        int slot = ap_table_find(bssid);
+        if (slot < 0) {
+            slot = alloc_slot();
+            if (slot < 0) continue;
+            ap_hot.bssid[slot] = bssid;
+            index_insert(slot);
+        }
+
+        ap_cold_t *cold = ap_table_cold(slot);
+        const char *ssid = (const char *)records[r].ssid;
+        if (cold->ssid_id == SSID_NONE || strncmp(ssid_pool_get(cold->ssid_id), ssid, SSID_MAX_LEN) != 0) {
+            ssid_pool_release(cold->ssid_id);
+            cold->ssid_id = ssid_pool_intern(ssid);
+        }
+        ap_hot.channel[slot] = records[r].primary;
+        ap_hot.rssi[slot] = records[r].rssi;
+        ap_hot.authmode[slot] = records[r].authmode;
+        cold->second = records[r].second;
+        cold->ess_id = roam_ess_id(ssid_pool_get(cold->ssid_id), records[r].authmode);
+        if (update_reset_clients && !cold->seen) {
+            memset(cold->clients, 0, sizeof(cold->clients));
+            ap_hot.client_count[slot] = 0;
+        }
+        cold->missed = 0;
+        cold->seen = true;
+        ap_table_locate(slot, where, records[r].rssi);
+    }
+}
+
+/* Frees the slots of APs that were looked for and missed too many times. */
+void ap_table_end_update(const channel_mask_t *scanned) {
+    int kept = 0;
+    for (int i = 0; i < active_count; i++) {
+        int slot = active_slots[i];
+        ap_cold_t *cold = ap_table_cold(slot);
+        if (cold->seen || (scanned && !channel_mask_test(scanned, ap_hot.channel[slot])) ||
+            ++cold->missed < AP_RETIRE_AFTER_MISSES) {
+            active_slots[kept++] = slot;
+        } else {
+            ssid_pool_release(cold->ssid_id);
+            cold->ssid_id = SSID_NONE;
+            index_remove(slot);
+            ap_hot.bssid[slot] = MAC_KEY_NONE;
+            free_slots[free_count++] = slot;
+            table_generation++;
+            retired_count++;
+        }
+    }
+    active_count = kept;
+}
+
+static int mac_index(const mac_key_t *list, int count, mac_key_t mac) {
+    for (int i = 0; i < count; i++) {
+        if (mac_key_eq(list[i], mac)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+wifi_second_chan_t ap_table_second(int slot) {
+    const ap_cold_t *cold = ap_table_cold(slot);
+    if (cold->ie_valid && cold->ie.primary == ap_hot.channel[slot]) {
+        switch (cold->ie.second) {
+        case IE_SECOND_ABOVE: return WIFI_SECOND_CHAN_ABOVE;
+        case IE_SECOND_BELOW: return WIFI_SECOND_CHAN_BELOW;
+        default: return WIFI_SECOND_CHAN_NONE;
+        }
+    }
+    return (wifi_second_chan_t)cold->second;
+}
+
+bool ap_table_has_client(int slot, mac_key_t client) {
+    return mac_index(ap_table_cold(slot)->clients, ap_hot.client_count[slot], client) >= 0;
+}
+
+void ap_table_locate(int slot, gps_ref_t where, int8_t rssi) {
+    ap_cold_t *cold = ap_table_cold(slot);
+    if (where == GPS_REF_NONE) return;
+    cold->seen_at = where;
+    if (where == cold->located_at) return;
+    gps_point_t at;
+    if (!gps_track_get(where, &at)) return;
+    cold->located_at = where;
+    ap_locate_add(&cold->loc, at.lat_e7, at.lon_e7, rssi);
+}
+
+bool ap_table_add_client(int slot, mac_key_t client, gps_ref_t where) {
+    ap_cold_t *cold = ap_table_cold(slot);
+    int n = ap_hot.client_count[slot];
+    int i = mac_index(cold->clients, n, client);
+    if (i >= 0) {
+        if (where != GPS_REF_NONE) cold->client_seen_at[i] = where;
+        return false;
+    }
+    if (n >= MAX_CLIENTS) return false;
+    cold->clients[n] = client;
+    cold->client_seen_at[n] = where;
+    ap_hot.client_count[slot] = n + 1;
+    return true;
+}
+
+void ap_table_fill_row(int slot, scan_result_t *row) {
+    strncpy(row->ssid, ssid_pool_get(ap_table_cold(slot)->ssid_id), sizeof(row->ssid) - 1);
+    row->ssid[sizeof(row->ssid) - 1] = '\0';
+    row->channel = ap_hot.channel[slot];
+    row->rssi = ap_hot.rssi[slot];
+    row->bssid = ap_hot.bssid[slot];
+    row->client_count = ap_hot.client_count[slot];
+    row->authmode = ap_table_authmode(slot);
+    row->slot = slot;
+
+    ap_locate_estimate_t est = { 0 };
+    row->located = ap_locate_estimate(&ap_table_cold(slot)->loc, &est);
+    row->lat_e7 = est.lat_e7;
+    row->lon_e7 = est.lon_e7;
+    row->radius_m = est.radius_m;
+}
+
+int ap_table_build_ess_view(ess_summary_t *out, int max) {
+    int count = 0;
+    for (int i = 0; i < active_count; i++) {
+        int slot = active_slots[i];
+        uint16_t ssid_id = ap_table_cold(slot)->ssid_id;
+        wifi_auth_mode_t authmode = ap_table_authmode(slot);
+        ess_summary_t *ess = NULL;
+        for (int e = 0; e < count; e++) {
+            if (out[e].ssid_id == ssid_id && out[e].authmode == authmode) {
+                ess = &out[e];
+                break;
+            }
+        }
+        if (!ess) {
+            if (count == max) continue;
+            ess = &out[count++];
+            memset(ess, 0, sizeof(*ess));
+            ess->ssid_id = ssid_id;
+            ess->authmode = authmode;
+            ess->best_rssi = INT8_MIN;
+        }
+        ess->bssids++;
+        ess->clients += ap_hot.client_count[slot];
+        ess->bands |= 1 << scan_band_of(ap_hot.channel[slot]);
+        if (ap_hot.rssi[slot] > ess->best_rssi) ess->best_rssi = ap_hot.rssi[slot];
+    }
+    return count;
+}
+
+void ap_table_get_stats(ap_table_stats_t *out) {
+    size_t hot_bytes = sizeof(mac_key_t) + sizeof(int8_t) + sizeof(uint8_t) + 2 * sizeof(uint16_t);
+
+    out->count = active_count;
+    out->capacity = pool_capacity;
+    out->max_aps = table_max_aps;
+    out->peak_count = peak_count;
+    out->missing = 0;
+    for (int i = 0; i < active_count; i++) {
+        if (ap_table_cold(active_slots[i])->missed) out->missing++;
+    }
+    out->retired = retired_count;
+    out->pool_bytes = pool_block_count * AP_POOL_BLOCK * sizeof(ap_cold_t) +
+                      table_max_aps * (hot_bytes + 2 * sizeof(uint16_t)) +
+                      (index_mask + 1) * sizeof(uint16_t);
+    /* Hot and cold entry, two snapshot rows, and a sort key. */
+    out->bytes_per_ap = hot_bytes + sizeof(ap_cold_t) + 2 * sizeof(scan_result_t) + 2 * sizeof(uint16_t);
+
+    /* Inline ssid[33] per AP versus a 2-byte id plus one shared slot per network. */
+    ssid_pool_stats_t pool;
+    ssid_pool_get_stats(&pool);
+    if (active_count > 0) {
+        long inline_bytes = (long)active_count * (SSID_MAX_LEN + 1);
+        long interned_bytes = (long)active_count * sizeof(uint16_t) + (long)pool.unique * pool.slot_bytes;
+        out->ssid_saving_per_100 = (inline_bytes - interned_bytes) * 100 / active_count;
+    } else {
+        out->ssid_saving_per_100 = 0;
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_wifi_types.h"
+
+#include "scan_snapshot.h"
+#include "channel_mask.h"
+#include "mac_key.h"
+#include "ie.h"
+#include "gps.h"
+#include "ap_locate.h"
+
+#define MAX_APS 160
+#define MAX_CLIENTS 10
+#define AP_POOL_BLOCK 16                /* entries per pool block */
+#define AP_TABLE_HEAP_RESERVE (48 * 1024) /* never grow the pool below this much free heap */
+#define AP_RETIRE_AFTER_MISSES 3        /* scans of its channel an AP may be missing from */
+
+/*
+ * Live AP table, split by access pattern. The fields the sniffer and the
+ * sorter touch on every frame or comparison (packed BSSID, RSSI, channel,
+ * client count, auth) live in parallel "hot" arrays indexed by slot id; the
+ * rest lives in "cold" entries from a block pool that grows on demand (up
+ * to the cap passed to ap_table_init) and never shrinks. Slot ids are
+ * stable for as long as a BSSID stays visible.
+ *
+ * Scans are merged by BSSID through an open-addressed index of slot ids,
+ * so a merge costs O(records). An AP missing from a scan that covered its
+ * channel is kept until it has been missing AP_RETIRE_AFTER_MISSES times.
+ */
+typedef struct {
+    uint16_t ssid_id;           /* interned, see ssid_pool.h */
+    uint32_t ess_id;            /* SSID + security key, see roam_ess_id */
+    mac_key_t clients[MAX_CLIENTS];
+    gps_ref_t client_seen_at[MAX_CLIENTS]; /* track point of each client's last frame with a fix */
+    gps_ref_t seen_at;          /* track point of the AP's last scan hit or beacon with a fix */
+    gps_ref_t located_at;       /* last track point fed to loc */
+    ap_locate_t loc;
+    uint8_t second;             /* wifi_second_chan_t from the scan record */
+    ie_info_t ie;               /* from the latest beacon */
+    bool ie_valid;              /* a beacon has been parsed into ie */
+    uint8_t missed;             /* consecutive scans of its channel without it */
+    bool seen;                  /* matched during the current update */
+} ap_cold_t;
+
+typedef struct {
+    mac_key_t *bssid;           /* MAC_KEY_NONE = free slot */
+    int8_t *rssi;
+    uint8_t *channel;
+    uint16_t *client_count;
+    uint16_t *authmode;
+} ap_hot_t;
+
+extern ap_hot_t ap_hot;
+
+/* One network (SSID + security) aggregated over its BSSIDs. */
+typedef struct {
+    uint16_t ssid_id;
+    wifi_auth_mode_t authmode;
+    uint16_t bssids;
+    uint16_t clients;
+    uint8_t bands;              /* bit per scan_band_t */
+    int8_t best_rssi;
+} ess_summary_t;
+
+typedef struct {
+    int count;
+    int capacity;
+    int max_aps;
+    int peak_count;
+    int missing;                /* kept by hysteresis, absent from the last scan */
+    uint32_t retired;
+    size_t pool_bytes;
+    size_t bytes_per_ap;        /* hot + cold entry plus its share of snapshot/sort data */
+    long ssid_saving_per_100;   /* bytes saved per 100 APs by interning vs inline ssid[33] */
+} ap_table_stats_t;
+
+esp_err_t ap_table_init(int max_aps);
+
+/* Grows the pool towards `wanted` entries as far as the heap allows; returns the capacity. */
+int ap_table_reserve(int wanted);
+
+/*
+ * A scan update: begin, merge records in any number of chunks, end. APs not
+ * seen count a miss only if their channel is in `scanned` (NULL = all).
+ */
+void ap_table_begin_update(bool reset_clients);
+void ap_table_merge(const wifi_ap_record_t *records, int count, gps_ref_t where);
+void ap_table_end_update(const channel_mask_t *scanned);
+
+/* Compact sort key: display order is a permutation over these, the entries themselves never move. */
+typedef struct {
+    int8_t rssi;
+    uint16_t slot;
+} ap_order_t;
+
+int ap_table_count(void);
+/*
+ * Fills `order` with the first `n` active slots and, if `by_rssi`, sorts
+ * them strongest first (ties by slot, so equal APs keep a stable order).
+ */
+void ap_table_order(ap_order_t *order, int n, bool by_rssi);
+/* Bumped whenever an AP is added or retired. */
+uint32_t ap_table_generation(void);
+int ap_table_slot_at(int index);
+int ap_table_find(mac_key_t bssid);
+void ap_table_get_channels(channel_mask_t *out);
+/*
+ * Tags a sighting of the AP itself (scan hit or beacon) with `where` and
+ * feeds it to the location estimate, at most once per track point, so
+ * standing still does not outweigh the positions passed while moving.
+ */
+void ap_table_locate(int slot, gps_ref_t where, int8_t rssi);
+bool ap_table_has_client(int slot, mac_key_t client);
+/* Records a frame from `client` heard at `where`; true if the client is new. */
+bool ap_table_add_client(int slot, mac_key_t client, gps_ref_t where);
+void ap_table_fill_row(int slot, scan_result_t *row);
+/* Secondary channel, from the HT operation IE once a beacon was parsed. */
+wifi_second_chan_t ap_table_second(int slot);
+
+ap_cold_t *ap_table_cold(int slot);
+
+static inline int8_t ap_table_rssi(int slot) { return ap_hot.rssi[slot]; }
+static inline uint8_t ap_table_channel(int slot) { return ap_hot.channel[slot]; }
+static inline int ap_table_client_count(int slot) { return ap_hot.client_count[slot]; }
+static inline wifi_auth_mode_t ap_table_authmode(int slot) { return (wifi_auth_mode_t)ap_hot.authmode[slot]; }
+
+static inline mac_key_t ap_table_bssid(int slot) { return ap_hot.bssid[slot]; }
+
+/* Groups the active APs by network; returns the number of ESS entries written. */
+int ap_table_build_ess_view(ess_summary_t *out, int max);
+
+void ap_table_get_stats(ap_table_stats_t *out);
@@ -0,0 +1,37 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+bool arena_init(arena_t *arena, size_t size) {
+    memset(arena, 0, sizeof(*arena));
+    arena->base = malloc(size);
+    if (!arena->base) return false;
+    arena->size = size;
+    return true;
+}
+
+void *arena_alloc(arena_t *arena, size_t size) {
+    size_t offset = (arena->used + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (offset > arena->size || size > arena->size - offset) {
+        /* Callers use the result unchecked; stop here rather than at a NULL dereference. */
+        fprintf(stderr, "cycle arena overflow: %zu bytes at offset %zu of %zu\n", size, offset, arena->size);
+        abort();
+    }
+    arena->used = offset + size;
+    if (arena->used > arena->high_water) arena->high_water = arena->used;
+    return arena->base + offset;
+}
+
+void *arena_calloc(arena_t *arena, size_t count, size_t size) {
+    void *p = arena_alloc(arena, size && count > SIZE_MAX / size ? SIZE_MAX : count * size);
+    memset(p, 0, count * size);
+    return p;
+}
+
+void arena_reset(arena_t *arena) {
+    arena->last_cycle_used = arena->used;
+    arena->used = 0;
+    arena->cycles++;
+}
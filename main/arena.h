@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Bump allocator for per-cycle scratch data. Memory is claimed once at init
+ * and handed out linearly; arena_reset() at the cycle boundary releases
+ * everything at once, so long-running use never fragments the heap.
+ * Not thread-safe: an arena belongs to one task.
+ */
+#define ARENA_ALIGN 8
+
+typedef struct {
+    uint8_t *base;
+    size_t size;
+    size_t used;
+    size_t high_water;          /* largest `used` seen across all cycles */
+    size_t last_cycle_used;     /* `used` at the most recent reset */
+    uint32_t cycles;
+} arena_t;
+
+bool arena_init(arena_t *arena, size_t size);
+
+/* Never returns NULL: an overflow aborts, NDEBUG or not. */
+void *arena_alloc(arena_t *arena, size_t size);
+void *arena_calloc(arena_t *arena, size_t count, size_t size);
+
+void arena_reset(arena_t *arena);
@@ -0,0 +1,19 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "bloom.h"
+
+bool bloom_init(bloom_t *bloom, uint32_t nbits, uint8_t k) {
+    uint32_t n = 32;
+    while (n < nbits) n <<= 1;
+    bloom->bits = calloc(n / 32, sizeof(uint32_t));
+    bloom->mask = n - 1;
+    bloom->k = k;
+    bloom->keys = 0;
+    return bloom->bits != NULL;
+}
+
+void bloom_clear(bloom_t *bloom) {
+    memset(bloom->bits, 0, (bloom->mask + 1) / 8);
+    bloom->keys = 0;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Bit-array Bloom filter over 64-bit keys. The k probe positions come from
+ * one multiplicative mix split into two halves (double hashing), so a test
+ * is one multiply and k bit reads. Sized to a power of two at init.
+ */
+typedef struct {
+    uint32_t *bits;
+    uint32_t mask;              /* bit count - 1 */
+    uint8_t k;
+    uint32_t keys;
+} bloom_t;
+
+bool bloom_init(bloom_t *bloom, uint32_t nbits, uint8_t k);
+void bloom_clear(bloom_t *bloom);
+
+static inline uint64_t bloom_mix(uint64_t key) {
+    key ^= key >> 31;
+    return key * 0x9E3779B97F4A7C15ull;
+}
+
+static inline void bloom_add(bloom_t *bloom, uint64_t key) {
+    uint64_t h = bloom_mix(key);
+    uint32_t h1 = (uint32_t)(h >> 32), h2 = (uint32_t)h | 1;
+    for (int i = 0; i < bloom->k; i++, h1 += h2) {
+        uint32_t bit = h1 & bloom->mask;
+        bloom->bits[bit >> 5] |= 1u << (bit & 31);
+    }
+    bloom->keys++;
+}
+
+/* False means definitely absent; true means probably present. */
+static inline bool bloom_maybe(const bloom_t *bloom, uint64_t key) {
+    uint64_t h = bloom_mix(key);
+    uint32_t h1 = (uint32_t)(h >> 32), h2 = (uint32_t)h | 1;
+    for (int i = 0; i < bloom->k; i++, h1 += h2) {
+        uint32_t bit = h1 & bloom->mask;
+        if (!(bloom->bits[bit >> 5] & (1u << (bit & 31)))) return false;
+    }
+    return true;
+}
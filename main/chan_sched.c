@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "esp_wifi_types.h"
+#include "chan_sched.h"
+
+typedef struct {
+    uint8_t channel;
+    uint8_t second;             /* wifi_second_chan_t */
+    bool planned;               /* has a dwell this cycle */
+    float discoveries;          /* decayed */
+    float seconds;              /* decayed dwell time */
+    uint32_t dwells;
+    uint32_t planned_ms;        /* this cycle's allocation */
+} chan_arm_t;
+
+static chan_arm_t arms[CHAN_SCHED_MAX_ARMS];
+static int arm_count;
+
+/* Planned arms are never recycled, so they stay put for the whole cycle. */
+static chan_arm_t *find_arm(uint8_t channel, uint8_t second) {
+    chan_arm_t *victim = NULL;
+    for (int i = 0; i < arm_count; i++) {
+        if (arms[i].channel == channel && arms[i].second == second) return &arms[i];
+        if (!arms[i].planned && (!victim || arms[i].seconds < victim->seconds)) victim = &arms[i];
+    }
+    if (arm_count < CHAN_SCHED_MAX_ARMS) victim = &arms[arm_count++];
+    else if (!victim) return NULL;
+    *victim = (chan_arm_t){ .channel = channel, .second = second };
+    return victim;
+}
+
+static float arm_score(const chan_arm_t *arm, uint32_t min_dwell_ms, float log_total) {
+    float t = arm->seconds + (arm->planned_ms - min_dwell_ms) / 1000.0f;
+    if (t <= 0.0f) return INFINITY;
+    return arm->discoveries / t + CHAN_SCHED_EXPLORE * sqrtf(log_total / t);
+}
+
+void chan_sched_allocate(const uint8_t *channels, const uint8_t *seconds, int n, uint32_t budget_ms,
+                         uint32_t min_dwell_ms, uint32_t *dwell_ms) {
+    float total_s = 0.0f;
+    for (int a = 0; a < arm_count; a++) {
+        arms[a].discoveries *= CHAN_SCHED_DECAY;
+        arms[a].seconds *= CHAN_SCHED_DECAY;
+        arms[a].planned = false;
+        arms[a].planned_ms = 0;
+        total_s += arms[a].seconds;
+    }
+
+    uint32_t spare = budget_ms;
+    for (int i = 0; i < n; i++) {
+        chan_arm_t *arm = find_arm(channels[i], seconds[i]);
+        if (arm) {
+            arm->planned = true;
+            arm->planned_ms = min_dwell_ms;
+        }
+        spare = spare > min_dwell_ms ? spare - min_dwell_ms : 0;
+    }
+
+    float log_total = logf(total_s + 1.0f + budget_ms / 1000.0f);
+    for (; spare >= CHAN_SCHED_QUANTUM_MS; spare -= CHAN_SCHED_QUANTUM_MS) {
+        chan_arm_t *best = NULL;
+        float best_score = -1.0f;
+        for (int a = 0; a < arm_count; a++) {
+            if (!arms[a].planned) continue;
+            float score = arm_score(&arms[a], min_dwell_ms, log_total);
+            if (score > best_score) {
+                best = &arms[a];
+                best_score = score;
+            }
+        }
+        if (!best) break;
+        best->planned_ms += CHAN_SCHED_QUANTUM_MS;
+    }
+
+    for (int i = 0; i < n; i++) {
+        chan_arm_t *arm = find_arm(channels[i], seconds[i]);
+        dwell_ms[i] = arm ? arm->planned_ms : min_dwell_ms;
+    }
+}
+
+void chan_sched_update(uint8_t channel, uint8_t second, uint32_t dwell_ms, uint32_t discoveries) {
+    chan_arm_t *arm = find_arm(channel, second);
+    if (!arm) return;
+    arm->discoveries += discoveries;
+    arm->seconds += dwell_ms / 1000.0f;
+    arm->dwells++;
+}
+
+void chan_sched_print_report(void) {
+    printf("Dwell schedule (ch[+/-HT40]: discoveries/min, ms this cycle):");
+    for (int a = 0; a < arm_count; a++) {
+        const chan_arm_t *arm = &arms[a];
+        if (!arm->planned) continue;
+        const char *width = arm->second == WIFI_SECOND_CHAN_ABOVE ? "+" :
+                            arm->second == WIFI_SECOND_CHAN_BELOW ? "-" : "";
+        float rate = arm->seconds > 0.0f ? 60.0f * arm->discoveries / arm->seconds : 0.0f;
+        printf(" %d%s: %.1f, %u", arm->channel, width, rate, (unsigned)arm->planned_ms);
+    }
+    printf("\n");
+}
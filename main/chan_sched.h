@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Cross-cycle sniff time scheduler. Each tuning (primary channel plus
+ * secondary offset, as planned by hop_plan) is a bandit arm whose reward is
+ * discoveries (new BSSID/client pairs) per second of dwell, both decayed
+ * every cycle so the estimate follows a changing environment. An HT40 dwell
+ * and a 20 MHz dwell on the same primary hear different APs, so they learn
+ * separately.
+ *
+ * A cycle's budget is split by UCB: every dwell first gets the minimum,
+ * then the remainder goes out in quanta, each to the arm with the highest
+ * mean + explore * sqrt(ln(total time) / arm time), where arm time is its
+ * decayed dwell time plus the quanta already planned for it this cycle.
+ * An arm that has never been sniffed has no time and scores highest, so
+ * each new tuning gets a quantum before high-yield arms take the rest.
+ */
+#define CHAN_SCHED_MAX_ARMS 64      /* the least-sniffed arm is recycled */
+#define CHAN_SCHED_DECAY 0.9f       /* per cycle */
+#define CHAN_SCHED_EXPLORE 0.5f
+#define CHAN_SCHED_QUANTUM_MS 250
+
+/* Writes a dwell time for the tuning (channels[i], seconds[i]) of each dwell;
+ * the sum is `budget_ms` (rounded down to whole quanta above the minimums).
+ * Decays all arms first. `seconds` holds wifi_second_chan_t values. */
+void chan_sched_allocate(const uint8_t *channels, const uint8_t *seconds, int n, uint32_t budget_ms,
+                         uint32_t min_dwell_ms, uint32_t *dwell_ms);
+void chan_sched_update(uint8_t channel, uint8_t second, uint32_t dwell_ms, uint32_t discoveries);
+void chan_sched_print_report(void);
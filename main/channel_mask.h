@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* Set of Wi-Fi channel numbers (0-255). */
+typedef struct {
+    uint32_t bits[8];
+} channel_mask_t;
+
+static inline void channel_mask_clear(channel_mask_t *mask) {
+    memset(mask, 0, sizeof(*mask));
+}
+
+static inline void channel_mask_set(channel_mask_t *mask, uint8_t channel) {
+    mask->bits[channel >> 5] |= 1u << (channel & 31);
+}
+
+static inline bool channel_mask_test(const channel_mask_t *mask, uint8_t channel) {
+    return (mask->bits[channel >> 5] >> (channel & 31)) & 1u;
+}
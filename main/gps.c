@@ -0,0 +1,324 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "driver/uart.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "gps.h"
+#include "nmea.h"
+#include "gps_config.h"
+
+#define TAG "GPS"
+#define GPS_UART_NUM UART_NUM_1
+#define GPS_RXD 23
+#define GPS_TXD 24
+#define GPS_BAUD 9600
+#define GPS_RX_BUFFER 2048
+#define GPS_EVENT_QUEUE_LEN 20
+#define GPS_READ_CHUNK 128
+#define GPS_TASK_STACK 4096
+#define GPS_TASK_PRIO 6
+
+typedef struct {
+    uint32_t bytes;
+    uint32_t uart_overflows;    /* FIFO or ring buffer full, bytes lost */
+    uint32_t uart_errors;       /* framing or parity */
+} gps_uart_stats_t;
+
+static QueueHandle_t gps_uart_queue = NULL;
+static nmea_reader_t gps_reader;
+static gps_uart_stats_t gps_uart_stats;
+static gps_config_result_t gps_link_config = { .baud = GPS_BAUD, .fix_interval_ms = 1000 };
+
+static portMUX_TYPE gps_lock = portMUX_INITIALIZER_UNLOCKED;
+static gps_fix_t gps_fix;
+static gps_point_t gps_track[GPS_TRACK_LEN];
+static uint32_t gps_track_count = 0;            /* points ever appended */
+static atomic_uint gps_track_latest = GPS_REF_NONE;
+
+void gps_format_coord(int32_t e7, char *buf, size_t len) {
+    uint32_t mag = e7 < 0 ? (uint32_t)-(int64_t)e7 : (uint32_t)e7;
+    uint32_t r = (mag + 50) / 100;
+    snprintf(buf, len, "%s%u.%05u", (e7 < 0 && r) ? "-" : "", (unsigned)(r / 100000), (unsigned)(r % 100000));
+}
+
+/* Owned by the GPS task. */
+static uint8_t gps_chunk[GPS_READ_CHUNK];
+
+esp_err_t gps_init(void) {
+    uart_config_t uart_config = {
+        .baud_rate = GPS_BAUD,
+        .data_bits = UART_DATA_8_BITS,
+        .parity    = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE
+    };
+    esp_err_t err = uart_driver_install(GPS_UART_NUM, GPS_RX_BUFFER, 0, GPS_EVENT_QUEUE_LEN, &gps_uart_queue, 0);
+    if (err != ESP_OK) return err;
+    uart_param_config(GPS_UART_NUM, &uart_config);
+    uart_set_pin(GPS_UART_NUM, GPS_TXD, GPS_RXD, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    nmea_reader_init(&gps_reader);
+    ESP_LOGI(TAG, "GPS UART initialized on RX=%d, TX=%d", GPS_RXD, GPS_TXD);
+    return ESP_OK;
+}
+
+bool gps_detect(void) {
+    char buffer[128];
+    for (int i = 0; i < 30; i++) {
+        int len = uart_read_bytes(GPS_UART_NUM, (uint8_t *)buffer, sizeof(buffer)-1, 100 / portTICK_PERIOD_MS);
+        if (len > 0) {
+            buffer[len] = '\0';
+            if (strstr(buffer, "$GP")) {
+                printf("GPS detected: YES\n");
+                return true;
+            }
+        }
+    }
+    printf("No GPS data detected - disabling GPS support\n");
+    return false;
+}
+
+void gps_send_command(const char *cmd) {
+    const char *newline = "\r\n";
+    uart_write_bytes(GPS_UART_NUM, cmd, strlen(cmd));
+    uart_write_bytes(GPS_UART_NUM, newline, 2);
+    ESP_LOGI(TAG, "Sent GPS command: %s", cmd);
+}
+
+static void link_write(void *ctx, const char *data, size_t len) {
+    uart_write_bytes(GPS_UART_NUM, data, len);
+    uart_wait_tx_done(GPS_UART_NUM, pdMS_TO_TICKS(100));
+}
+
+static int link_read(void *ctx, uint8_t *buf, size_t len, uint32_t timeout_ms) {
+    int n = uart_read_bytes(GPS_UART_NUM, buf, len, pdMS_TO_TICKS(timeout_ms));
+    return n > 0 ? n : 0;
+}
+
+static void link_set_baud(void *ctx, uint32_t baud) {
+    uart_set_baudrate(GPS_UART_NUM, baud);
+    uart_flush_input(GPS_UART_NUM);
+}
+
+static uint32_t link_now_ms(void *ctx) {
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+bool gps_configure(void) {
+    const gps_link_t link = {
+        .write = link_write,
+        .read = link_read,
+        .set_baud = link_set_baud,
+        .now_ms = link_now_ms,
+    };
+    bool ok = gps_config_negotiate(&link, GPS_BAUD, &gps_link_config);
+    /* Events queued while the port was read directly are stale. */
+    xQueueReset(gps_uart_queue);
+    if (!ok) {
+        printf("GPS link: module went silent after a baud switch (%u fallbacks)\n",
+               (unsigned)gps_link_config.baud_fallbacks);
+        return false;
+    }
+    printf("GPS link: %u baud, fix every %u ms%s\n", (unsigned)gps_link_config.baud,
+           gps_link_config.fix_interval_ms, gps_link_config.output_acked ? "" : " (module ignored PMTK, defaults kept)");
+    return true;
+}
+
+void gps_get_fix(gps_fix_t *out) {
+    portENTER_CRITICAL(&gps_lock);
+    *out = gps_fix;
+    portEXIT_CRITICAL(&gps_lock);
+}
+
+static void parse_rmc(const nmea_fields_t *f) {
+    int64_t rx_us = esp_timer_get_time();
+    int64_t utc_us;
+    if (!nmea_rmc_utc(f, &utc_us)) return;
+
+    /* The offset includes the sentence's serial latency, a fairly constant
+     * few hundred ms at most; it is the same for every converted timestamp. */
+    portENTER_CRITICAL(&gps_lock);
+    gps_fix.utc_us = utc_us;
+    gps_fix.utc_offset_us = utc_us - rx_us;
+    gps_fix.utc_valid = true;
+    portEXIT_CRITICAL(&gps_lock);
+
+    /* Our own stamps go through gps_utc_from_timer(); the system clock is
+     * kept for time() users and stepped only when off by more than a second. */
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    time_t utc = utc_us / 1000000;
+    if (llabs((long long)now.tv_sec - utc) > 1) {
+        struct timeval tv = {
+            .tv_sec = utc,
+            .tv_usec = utc_us % 1000000
+        };
+        settimeofday(&tv, NULL);
+        struct tm tm;
+        gmtime_r(&utc, &tm);
+        ESP_LOGI(TAG, "RTC updated from GPS: %04d-%02d-%02d %02d:%02d:%02d",
+                 tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+    }
+}
+
+bool gps_utc_from_timer(int64_t timer_us, int64_t *utc_us) {
+    portENTER_CRITICAL(&gps_lock);
+    bool valid = gps_fix.utc_valid;
+    int64_t offset = gps_fix.utc_offset_us;
+    portEXIT_CRITICAL(&gps_lock);
+    if (valid) *utc_us = timer_us + offset;
+    return valid;
+}
+
+static void track_update(const gps_fix_t *fix) {
+    if (!fix->valid) {
+        atomic_store_explicit(&gps_track_latest, GPS_REF_NONE, memory_order_release);
+        return;
+    }
+    if (gps_track_count > 0) {
+        const gps_point_t *last = &gps_track[(gps_track_count - 1) & (GPS_TRACK_LEN - 1)];
+        if (abs(fix->lat_e7 - last->lat_e7) + abs(fix->lon_e7 - last->lon_e7) < GPS_TRACK_MIN_MOVE_E7) {
+            atomic_store_explicit(&gps_track_latest, gps_track_count, memory_order_release);
+            return;
+        }
+    }
+
+    portENTER_CRITICAL(&gps_lock);
+    gps_point_t *p = &gps_track[gps_track_count & (GPS_TRACK_LEN - 1)];
+    p->lat_e7 = fix->lat_e7;
+    p->lon_e7 = fix->lon_e7;
+    p->time_ms = (uint32_t)(fix->updated_us / 1000);
+    gps_track_count++;
+    portEXIT_CRITICAL(&gps_lock);
+    atomic_store_explicit(&gps_track_latest, gps_track_count, memory_order_release);
+}
+
+gps_ref_t gps_track_ref(void) {
+    return atomic_load_explicit(&gps_track_latest, memory_order_acquire);
+}
+
+bool gps_track_get(gps_ref_t ref, gps_point_t *out) {
+    if (ref == GPS_REF_NONE) return false;
+    portENTER_CRITICAL(&gps_lock);
+    bool live = gps_track_count - ref < GPS_TRACK_LEN;
+    if (live) *out = gps_track[(ref - 1) & (GPS_TRACK_LEN - 1)];
+    portEXIT_CRITICAL(&gps_lock);
+    return live;
+}
+
+static void parse_gga(const nmea_fields_t *f) {
+    int lat_len, ns_len, lon_len, ew_len, quality_len, sats_len;
+    const char *lat_str = nmea_field(f, 2, &lat_len);
+    const char *ns = nmea_field(f, 3, &ns_len);
+    const char *lon_str = nmea_field(f, 4, &lon_len);
+    const char *ew = nmea_field(f, 5, &ew_len);
+    const char *quality = nmea_field(f, 6, &quality_len);
+    const char *sats = nmea_field(f, 7, &sats_len);
+
+    gps_fix_t fix;
+    gps_get_fix(&fix);
+
+    int32_t lat, lon;
+    if (!ns_len || !ew_len || !quality_len || quality[0] == '0' ||
+        !nmea_parse_coord(lat_str, lat_len, ns[0], &lat) ||
+        !nmea_parse_coord(lon_str, lon_len, ew[0], &lon)) {
+        fix.valid = false;
+    } else {
+        fix.lat_e7 = lat;
+        fix.lon_e7 = lon;
+        fix.valid = true;
+        /* The field ends at ',', which stops atoi. */
+        fix.satellites = sats_len ? atoi(sats) : 0;
+        ESP_LOGD(TAG, "Parsed GPS: %ld, %ld (1e-7 deg), %d satellites",
+                 (long)fix.lat_e7, (long)fix.lon_e7, fix.satellites);
+    }
+    fix.updated_us = esp_timer_get_time();
+
+    portENTER_CRITICAL(&gps_lock);
+    gps_fix.valid = fix.valid;
+    gps_fix.lat_e7 = fix.lat_e7;
+    gps_fix.lon_e7 = fix.lon_e7;
+    gps_fix.satellites = fix.satellites;
+    gps_fix.updated_us = fix.updated_us;
+    portEXIT_CRITICAL(&gps_lock);
+    track_update(&fix);
+}
+
+static void on_sentence(void *ctx, const nmea_fields_t *f) {
+    switch (f->type) {
+    case NMEA_TYPE_GGA:
+        parse_gga(f);
+        break;
+    case NMEA_TYPE_RMC:
+        parse_rmc(f);
+        break;
+    default:
+        break;
+    }
+}
+
+static void gps_task(void *arg) {
+    uart_event_t event;
+    for (;;) {
+        if (xQueueReceive(gps_uart_queue, &event, portMAX_DELAY) != pdTRUE) continue;
+
+        switch (event.type) {
+        case UART_DATA: {
+            size_t left = event.size;
+            while (left > 0) {
+                int n = uart_read_bytes(GPS_UART_NUM, gps_chunk,
+                                        left < sizeof(gps_chunk) ? left : sizeof(gps_chunk), 0);
+                if (n <= 0) break;
+                gps_uart_stats.bytes += n;
+                nmea_feed(&gps_reader, gps_chunk, n, on_sentence, NULL);
+                left -= n;
+            }
+            break;
+        }
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+            /* Bytes are gone; drop the half sentence and start clean. */
+            gps_uart_stats.uart_overflows++;
+            uart_flush_input(GPS_UART_NUM);
+            xQueueReset(gps_uart_queue);
+            nmea_reader_reset(&gps_reader);
+            break;
+        case UART_FRAME_ERR:
+        case UART_PARITY_ERR:
+            gps_uart_stats.uart_errors++;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+esp_err_t gps_start(void) {
+    if (xTaskCreate(gps_task, "gps_task", GPS_TASK_STACK, NULL, GPS_TASK_PRIO, NULL) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void gps_print_stats(void) {
+    static uint32_t last_sentences = 0;
+    static int64_t last_us = 0;
+
+    int64_t now = esp_timer_get_time();
+    uint32_t sentences = gps_reader.sentences;
+    unsigned rate_x10 = last_us ? (unsigned)((sentences - last_sentences) * 10000000LL / (now - last_us)) : 0;
+    last_sentences = sentences;
+    last_us = now;
+
+    printf("GPS: %u baud, %u ms fixes, %u.%u sentences/s, %u checksum failures, %u overruns, %u UART overflows, %u UART errors, %u bytes\n",
+           (unsigned)gps_link_config.baud, gps_link_config.fix_interval_ms, rate_x10 / 10, rate_x10 % 10, (unsigned)gps_reader.checksum_errors, (unsigned)gps_reader.overruns,
+           (unsigned)gps_uart_stats.uart_overflows, (unsigned)gps_uart_stats.uart_errors,
+           (unsigned)gps_uart_stats.bytes);
+}
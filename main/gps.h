@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+/*
+ * GPS receiver on a UART. A dedicated task waits on the UART driver's event
+ * queue, streams every byte through the NMEA framer and publishes a fix as
+ * soon as a GGA or RMC sentence arrives; readers copy the latest one out
+ * with gps_get_fix().
+ */
+typedef struct {
+    bool valid;                 /* GGA fix quality above 0 */
+    int32_t lat_e7;             /* 1e-7 degrees */
+    int32_t lon_e7;
+    int satellites;
+    bool utc_valid;             /* an RMC with date and time was seen */
+    int64_t utc_us;             /* last RMC time, microseconds since the epoch */
+    int64_t utc_offset_us;      /* GPS UTC minus esp_timer_get_time() */
+    int64_t updated_us;         /* esp_timer time of the last GGA */
+} gps_fix_t;
+
+/*
+ * Track ring: each fix that moved at least GPS_TRACK_MIN_MOVE_E7 from the
+ * previous point is appended. Observations keep a 4-byte gps_ref_t into it
+ * instead of copied coordinates; a ref resolves until the ring wraps past
+ * it, and while standing still the ring does not advance at all.
+ */
+#define GPS_TRACK_LEN 1024          /* power of two */
+#define GPS_TRACK_MIN_MOVE_E7 20    /* |dlat| + |dlon|, about 2 m */
+
+typedef uint32_t gps_ref_t;
+#define GPS_REF_NONE 0
+
+typedef struct {
+    int32_t lat_e7;
+    int32_t lon_e7;
+    uint32_t time_ms;           /* esp_timer time the point was first reached */
+} gps_point_t;
+
+esp_err_t gps_init(void);
+/* Blocks up to ~3 s listening for NMEA traffic. */
+bool gps_detect(void);
+void gps_send_command(const char *cmd);
+/*
+ * Negotiates output sentences, baud rate and fix rate (see gps_config.h)
+ * and reconfigures the UART to match. Call after gps_detect(), before
+ * gps_start(); blocks for up to about ten seconds if the module does not
+ * follow the baud switch. False if the module stopped talking.
+ */
+bool gps_configure(void);
+esp_err_t gps_start(void);
+
+void gps_get_fix(gps_fix_t *out);
+/* Converts an esp_timer_get_time() stamp to UTC microseconds; false until
+ * the first RMC. */
+bool gps_utc_from_timer(int64_t timer_us, int64_t *utc_us);
+/* Formats 1e-7 degrees as a decimal string rounded to 5 places. */
+void gps_format_coord(int32_t e7, char *buf, size_t len);
+void gps_print_stats(void);
+
+/* The point of the current fix, GPS_REF_NONE without one. Lock-free, so
+ * it can be called from the Wi-Fi receive callback. */
+gps_ref_t gps_track_ref(void);
+bool gps_track_get(gps_ref_t ref, gps_point_t *out);
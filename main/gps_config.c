@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "gps_config.h"
+#include "nmea.h"
+
+static const uint32_t baud_candidates[] = { 115200, 57600, 38400 };
+static const uint16_t interval_candidates[] = { 100, 200, 500 };
+
+typedef struct {
+    const gps_link_t *link;
+    nmea_reader_t reader;
+    int ack_cmd;                /* PMTK command a PMTK001 is awaited for, -1 = none */
+    int ack_flag;               /* 3 = success, -1 = no reply yet */
+    uint32_t sentences;
+} negotiation_t;
+
+static void on_sentence(void *ctx, const nmea_fields_t *f) {
+    negotiation_t *neg = ctx;
+    neg->sentences++;
+    if (f->type != NMEA_TYPE_PROPRIETARY || neg->ack_cmd < 0) return;
+
+    int len, cmd_len, flag_len;
+    const char *name = nmea_field(f, 0, &len);
+    const char *cmd = nmea_field(f, 1, &cmd_len);
+    const char *flag = nmea_field(f, 2, &flag_len);
+    if (len != 7 || memcmp(name, "PMTK001", 7) != 0 || cmd_len != 3 || flag_len != 1) return;
+    if (nmea_parse_digits(cmd, 3) == neg->ack_cmd) neg->ack_flag = nmea_parse_digits(flag, 1);
+}
+
+/* Feeds the reader until an awaited ACK arrives, `sentences` were seen, or timeout. */
+static void pump(negotiation_t *neg, uint32_t timeout_ms, uint32_t sentences) {
+    const gps_link_t *link = neg->link;
+    uint32_t start = link->now_ms(link->ctx);
+    uint8_t chunk[64];
+    while (neg->ack_flag < 0 && neg->sentences < sentences) {
+        uint32_t elapsed = link->now_ms(link->ctx) - start;
+        if (elapsed >= timeout_ms) break;
+        uint32_t wait = timeout_ms - elapsed;
+        int n = link->read(link->ctx, chunk, sizeof(chunk), wait < GPS_CONFIG_POLL_MS ? wait : GPS_CONFIG_POLL_MS);
+        if (n > 0) nmea_feed(&neg->reader, chunk, n, on_sentence, neg);
+    }
+}
+
+static void send_pmtk(negotiation_t *neg, const char *body) {
+    char line[64];
+    uint8_t sum = 0;
+    for (const char *p = body; *p; p++) sum ^= (uint8_t)*p;
+    int len = snprintf(line, sizeof(line), "$%s*%02X\r\n", body, sum);
+    neg->link->write(neg->link->ctx, line, len);
+}
+
+/* Sends a PMTK command and waits for its PMTK001; returns the flag or -1. */
+static int command(negotiation_t *neg, int cmd, const char *body) {
+    neg->ack_cmd = cmd;
+    neg->ack_flag = -1;
+    send_pmtk(neg, body);
+    pump(neg, GPS_CONFIG_ACK_MS, UINT32_MAX);
+    neg->ack_cmd = -1;
+    return neg->ack_flag;
+}
+
+static bool heard_at(negotiation_t *neg, uint32_t baud) {
+    neg->link->set_baud(neg->link->ctx, baud);
+    nmea_reader_reset(&neg->reader);
+    neg->sentences = 0;
+    neg->ack_flag = -1;
+    pump(neg, GPS_CONFIG_VERIFY_MS, GPS_CONFIG_VERIFY_SENTENCES);
+    return neg->sentences >= GPS_CONFIG_VERIFY_SENTENCES;
+}
+
+bool gps_config_negotiate(const gps_link_t *link, uint32_t baud, gps_config_result_t *out) {
+    negotiation_t neg = { .link = link, .ack_cmd = -1, .ack_flag = -1 };
+    nmea_reader_init(&neg.reader);
+    memset(out, 0, sizeof(*out));
+    out->baud = baud;
+    out->fix_interval_ms = 1000;
+
+    /* GGA and RMC only, so a faster fix rate fits the link. */
+    out->output_acked = command(&neg, 314, "PMTK314,0,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0") == 3;
+    if (!out->output_acked) return true;    /* not a PMTK module, leave it alone */
+
+    for (size_t i = 0; i < sizeof(baud_candidates) / sizeof(baud_candidates[0]); i++) {
+        uint32_t want = baud_candidates[i];
+        if (want <= out->baud) break;
+        char body[24];
+        snprintf(body, sizeof(body), "PMTK251,%u", (unsigned)want);
+        send_pmtk(&neg, body);
+        if (heard_at(&neg, want)) {
+            out->baud = want;
+            break;
+        }
+        out->baud_fallbacks++;
+        if (!heard_at(&neg, out->baud)) {
+            /* Switched somewhere we cannot hear, or stopped talking. */
+            out->module_lost = true;
+            return false;
+        }
+    }
+
+    uint32_t bytes_per_s = out->baud / 10;
+    uint32_t min_interval = GPS_CONFIG_FIX_BYTES * 1000u * 100u / (bytes_per_s * GPS_CONFIG_MAX_LOAD_PCT);
+    if (min_interval < GPS_CONFIG_MIN_INTERVAL_MS) min_interval = GPS_CONFIG_MIN_INTERVAL_MS;
+    for (size_t i = 0; i < sizeof(interval_candidates) / sizeof(interval_candidates[0]); i++) {
+        uint16_t want = interval_candidates[i];
+        if (want < min_interval) continue;
+        char body[24];
+        snprintf(body, sizeof(body), "PMTK220,%u", want);
+        if (command(&neg, 220, body) == 3) {
+            out->fix_interval_ms = want;
+            break;
+        }
+        out->rate_rejects++;
+    }
+    return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Start-up negotiation with an MTK-style GPS: trims the output to GGA and
+ * RMC (PMTK314), moves the link to the fastest baud rate the module follows
+ * (PMTK251) and then asks for the shortest fix interval that baud rate can
+ * carry (PMTK220).
+ *
+ * PMTK251 is not acknowledged at either rate, so a baud switch counts only
+ * once checksummed sentences arrive at the new rate; otherwise the UART goes
+ * back to the old one and the next, slower candidate is tried. If it is not
+ * heard at the old rate either, negotiation stops and reports the module
+ * lost. A PMTK220 is accepted only on a PMTK001 success reply. A module that
+ * does not acknowledge the PMTK314 is left at its power-on baud rate and 1 Hz.
+ *
+ * The serial port is reached only through gps_link_t, so a scripted module
+ * can stand in on a host. Runs before the GPS task owns the port.
+ */
+#define GPS_CONFIG_ACK_MS 1500          /* PMTK001 wait, spans at least one 1 Hz fix */
+#define GPS_CONFIG_VERIFY_MS 2500       /* wait for sentences after a baud switch */
+#define GPS_CONFIG_VERIFY_SENTENCES 2
+#define GPS_CONFIG_POLL_MS 20
+#define GPS_CONFIG_FIX_BYTES 160        /* one GGA + RMC pair */
+#define GPS_CONFIG_MAX_LOAD_PCT 50      /* of the link's byte rate */
+#define GPS_CONFIG_MIN_INTERVAL_MS 100  /* 10 Hz */
+
+typedef struct {
+    void *ctx;
+    /* Returns once the bytes are on the wire. */
+    void (*write)(void *ctx, const char *data, size_t len);
+    /* Up to len bytes within timeout_ms; 0 on timeout. */
+    int (*read)(void *ctx, uint8_t *buf, size_t len, uint32_t timeout_ms);
+    /* Also discards anything received at the old rate. */
+    void (*set_baud)(void *ctx, uint32_t baud);
+    uint32_t (*now_ms)(void *ctx);
+} gps_link_t;
+
+typedef struct {
+    uint32_t baud;
+    uint16_t fix_interval_ms;
+    bool output_acked;          /* PMTK314 */
+    bool module_lost;           /* silent at both rates after a PMTK251 */
+    uint8_t baud_fallbacks;     /* candidates the module did not follow */
+    uint8_t rate_rejects;       /* PMTK220 intervals refused or not acknowledged */
+} gps_config_result_t;
+
+/* Always leaves the link at a baud rate the module was last heard on;
+ * false if out->module_lost. */
+bool gps_config_negotiate(const gps_link_t *link, uint32_t baud, gps_config_result_t *out);
@@ -0,0 +1,86 @@
+#include <stdio.h>
+
+#include "hop_plan.h"
+
+static bool covers(const hop_dwell_t *t, const hop_ap_t *a, bool ht40) {
+    if (!ht40) return a->channel == t->channel;
+    if (a->channel == t->channel) {
+        return a->second == WIFI_SECOND_CHAN_NONE || a->second == t->second;
+    }
+    if (t->second == WIFI_SECOND_CHAN_ABOVE) {
+        return a->second == WIFI_SECOND_CHAN_BELOW && a->channel == t->channel + 4;
+    }
+    if (t->second == WIFI_SECOND_CHAN_BELOW) {
+        return a->second == WIFI_SECOND_CHAN_ABOVE && a->channel + 4 == t->channel;
+    }
+    return false;
+}
+
+int hop_plan_build(hop_ap_t *aps, int n, bool ht40, hop_dwell_t *out) {
+    int count = 0;
+    int remaining = n;
+
+    for (int i = 0; i < n; i++) aps[i].covered = false;
+
+    while (remaining > 0) {
+        hop_dwell_t best = {0};
+
+        /* Each uncovered AP proposes its own tuning; keep the widest cover,
+         * HT40 only where it covers more than an HT20 dwell would. */
+        for (int i = 0; i < n; i++) {
+            if (aps[i].covered) continue;
+            hop_dwell_t t = {
+                .channel = aps[i].channel,
+                .second = ht40 ? aps[i].second : WIFI_SECOND_CHAN_NONE,
+            };
+            for (int j = 0; j < n; j++) {
+                if (!aps[j].covered && covers(&t, &aps[j], ht40)) t.aps++;
+            }
+            if (t.aps > best.aps ||
+                (t.aps == best.aps && t.second == WIFI_SECOND_CHAN_NONE && best.second != WIFI_SECOND_CHAN_NONE)) {
+                best = t;
+            }
+        }
+
+        for (int j = 0; j < n; j++) {
+            if (!aps[j].covered && covers(&best, &aps[j], ht40)) {
+                aps[j].covered = true;
+                remaining--;
+            }
+        }
+        out[count++] = best;
+    }
+
+    for (int i = 1; i < count; i++) {
+        hop_dwell_t d = out[i];
+        int j = i;
+        for (; j > 0 && out[j - 1].channel > d.channel; j--) out[j] = out[j - 1];
+        out[j] = d;
+    }
+    return count;
+}
+
+void hop_yield_add(hop_yield_t *yield, const hop_dwell_t *dwell, uint32_t frames, uint32_t new_clients) {
+    int mode = dwell->second != WIFI_SECOND_CHAN_NONE;
+    yield->dwells[mode]++;
+    yield->aps[mode] += dwell->aps;
+    yield->frames[mode] += frames;
+    yield->new_clients[mode] += new_clients;
+}
+
+void hop_plan_print_report(const hop_dwell_t *dwells, int count, const hop_yield_t *yield) {
+    int ht40 = 0;
+    for (int i = 0; i < count; i++) ht40 += dwells[i].second != WIFI_SECOND_CHAN_NONE;
+    printf("Hop plan: %d dwells (%d HT40)\n", count, ht40);
+
+    static const char *const mode_names[2] = { "HT20", "HT40" };
+    for (int m = 0; m < 2; m++) {
+        uint32_t d = yield->dwells[m];
+        if (!d) continue;
+        printf("  %s: %u dwells, %u.%u APs, %u frames, %u.%02u new clients per dwell\n",
+               mode_names[m], (unsigned)d,
+               (unsigned)(yield->aps[m] / d), (unsigned)(yield->aps[m] * 10 / d % 10),
+               (unsigned)(yield->frames[m] / d),
+               (unsigned)(yield->new_clients[m] / d), (unsigned)(yield->new_clients[m] * 100 / d % 100));
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "esp_wifi_types.h"
+
+/*
+ * Sniff hop planner. Turns the tracked APs into a list of dwells, one
+ * per (primary channel, secondary offset) tuning. With ht40 set, a dwell
+ * tuned HT40 ABOVE/BELOW counts as covering:
+ * - every AP on its primary channel that is 20 MHz or uses the same offset
+ * - APs whose primary is the dwell's secondary and that point back at it
+ * Dwells are then chosen greedily by coverage. Without ht40, every dwell
+ * is 20 MHz and one dwell covers every AP on its channel.
+ */
+typedef struct {
+    uint8_t channel;
+    uint8_t second;             /* wifi_second_chan_t */
+    bool covered;
+} hop_ap_t;
+
+typedef struct {
+    uint8_t channel;
+    uint8_t second;             /* wifi_second_chan_t */
+    uint16_t aps;               /* tracked APs this dwell covers */
+} hop_dwell_t;
+
+/* Capture yield, [0] for 20 MHz dwells and [1] for HT40 dwells. */
+typedef struct {
+    uint32_t dwells[2];
+    uint32_t aps[2];
+    uint32_t frames[2];
+    uint32_t new_clients[2];
+} hop_yield_t;
+
+/* Fills `out` (room for n dwells), sorted by channel; returns the count. */
+int hop_plan_build(hop_ap_t *aps, int n, bool ht40, hop_dwell_t *out);
+
+void hop_yield_add(hop_yield_t *yield, const hop_dwell_t *dwell, uint32_t frames, uint32_t new_clients);
+void hop_plan_print_report(const hop_dwell_t *dwells, int count, const hop_yield_t *yield);
@@ -0,0 +1,101 @@
+#include <string.h>
+
+#include "ie.h"
+
+static const uint8_t ieee_oui[3] = { 0x00, 0x0F, 0xAC };
+
+/* Suite list: 2-byte count followed by 4-byte OUI+type entries. */
+static const uint8_t *read_suites(const uint8_t *p, const uint8_t *end, uint32_t *mask) {
+    if (end - p < 2) return NULL;
+    int count = p[0] | (p[1] << 8);
+    p += 2;
+    if (end - p < count * 4) return NULL;
+    for (int i = 0; i < count; i++, p += 4) {
+        if (memcmp(p, ieee_oui, 3) == 0 && p[3] < 32) *mask |= 1u << p[3];
+    }
+    return p;
+}
+
+static void parse_rsn(const ie_t *ie, ie_info_t *out) {
+    const uint8_t *p = ie->data;
+    const uint8_t *end = ie->data + ie->len;
+
+    if (end - p < 2) return;
+    out->flags |= IE_HAS_RSN;
+    p += 2;                                         /* version */
+    if (end - p < 4) return;
+    if (memcmp(p, ieee_oui, 3) == 0) out->group_cipher = p[3];
+    p += 4;
+    if (!(p = read_suites(p, end, &out->pairwise_ciphers))) return;
+    if (!(p = read_suites(p, end, &out->akms))) return;
+    if (end - p < 2) return;
+    if (p[0] & 0x40) out->pmf = IE_PMF_REQUIRED;    /* MFPR */
+    else if (p[0] & 0x80) out->pmf = IE_PMF_CAPABLE; /* MFPC */
+}
+
+void ie_parse(const uint8_t *ies, size_t len, ie_info_t *out) {
+    ie_iter_t it;
+    ie_t ie;
+
+    memset(out, 0, sizeof(*out));
+    out->width_mhz = 20;
+    ie_iter_init(&it, ies, len);
+    while (ie_next(&it, &ie)) {
+        switch (ie.id) {
+        case IE_ID_RSN:
+            parse_rsn(&ie, out);
+            break;
+        case IE_ID_COUNTRY:
+            if (ie.len >= 2) {
+                out->flags |= IE_HAS_COUNTRY;
+                out->country[0] = ie.data[0];
+                out->country[1] = ie.data[1];
+            }
+            break;
+        case IE_ID_BSS_LOAD:
+            if (ie.len >= 5) {
+                out->flags |= IE_HAS_BSS_LOAD;
+                out->station_count = ie.data[0] | (ie.data[1] << 8);
+                out->channel_util = ie.data[2];
+            }
+            break;
+        case IE_ID_HT_CAP:
+            out->flags |= IE_HAS_HT;
+            break;
+        case IE_ID_HT_OP:
+            if (ie.len >= 2) {
+                out->primary = ie.data[0];
+                out->second = ie.data[1] & 0x03;
+                if (out->second == 2) out->second = IE_SECOND_NONE;
+                if (out->second != IE_SECOND_NONE && (ie.data[1] & 0x04) && out->width_mhz < 40) {
+                    out->width_mhz = 40;
+                }
+            }
+            break;
+        case IE_ID_VHT_CAP:
+            out->flags |= IE_HAS_VHT;
+            break;
+        case IE_ID_VHT_OP:
+            /* 1 = 80 MHz, or 160 when the second centre segment is set. */
+            if (ie.len >= 3 && ie.data[0] == 1) out->width_mhz = ie.data[2] ? 160 : 80;
+            else if (ie.len >= 1 && ie.data[0] >= 2) out->width_mhz = 160;
+            break;
+        case IE_ID_EXTENSION:
+            if (ie.ext_id == IE_EXT_HE_CAP) out->flags |= IE_HAS_HE;
+            break;
+        }
+    }
+}
+
+const char *ie_cipher_name(uint8_t suite) {
+    switch (suite) {
+    case 1: return "WEP40";
+    case 2: return "TKIP";
+    case 4: return "CCMP";
+    case 5: return "WEP104";
+    case 8: return "GCMP";
+    case 9: return "GCMP256";
+    case 10: return "CCMP256";
+    default: return "-";
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Information elements from beacon and probe-response bodies. The iterator
+ * hands out pointers into the caller's frame buffer and never reads past
+ * `end`; a truncated element ends the walk. ie_parse() runs the typed
+ * decoders over one body into a compact ie_info_t. It only looks at the
+ * headers of elements it does not decode, so it is cheap enough to run on
+ * every beacon.
+ */
+#define IE_ID_SSID 0
+#define IE_ID_COUNTRY 7
+#define IE_ID_TIM 5
+#define IE_ID_BSS_LOAD 11
+#define IE_ID_HT_CAP 45
+#define IE_ID_RSN 48
+#define IE_ID_HT_OP 61
+#define IE_ID_VHT_CAP 191
+#define IE_ID_VHT_OP 192
+#define IE_ID_EXTENSION 255
+#define IE_EXT_HE_CAP 35
+#define IE_EXT_HE_OP 36
+
+#define IE_BEACON_FIXED_LEN 12      /* timestamp, interval, capability */
+
+/* ie_info_t.flags */
+#define IE_HAS_RSN      0x01
+#define IE_HAS_HT       0x02
+#define IE_HAS_VHT      0x04
+#define IE_HAS_HE       0x08
+#define IE_HAS_COUNTRY  0x10
+#define IE_HAS_BSS_LOAD 0x20
+
+typedef enum {
+    IE_PMF_NONE,
+    IE_PMF_CAPABLE,
+    IE_PMF_REQUIRED
+} ie_pmf_t;
+
+typedef enum {
+    IE_SECOND_NONE = 0,
+    IE_SECOND_ABOVE = 1,
+    IE_SECOND_BELOW = 3             /* HT operation encoding */
+} ie_second_t;
+
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+} ie_iter_t;
+
+typedef struct {
+    uint8_t id;
+    uint8_t ext_id;                 /* for IE_ID_EXTENSION, else 0 */
+    uint8_t len;                    /* of data, excluding ext_id */
+    const uint8_t *data;
+} ie_t;
+
+typedef struct {
+    uint8_t flags;
+    uint8_t pmf;                    /* ie_pmf_t */
+    uint8_t group_cipher;           /* 00-0F-AC suite type, 0 if none */
+    uint32_t pairwise_ciphers;      /* bit per 00-0F-AC suite type */
+    uint32_t akms;                  /* bit per 00-0F-AC AKM type */
+    char country[3];
+    uint8_t primary;                /* from HT operation, 0 if absent */
+    uint8_t second;                 /* ie_second_t */
+    uint16_t width_mhz;
+    uint16_t station_count;         /* BSS Load */
+    uint8_t channel_util;           /* BSS Load, 0-255 */
+} ie_info_t;
+
+static inline void ie_iter_init(ie_iter_t *it, const uint8_t *body, size_t len) {
+    it->p = body;
+    it->end = body + len;
+}
+
+static inline bool ie_next(ie_iter_t *it, ie_t *out) {
+    if (it->end - it->p < 2) return false;
+    uint8_t len = it->p[1];
+    if (it->end - it->p - 2 < len) return false;
+    out->id = it->p[0];
+    out->ext_id = 0;
+    out->len = len;
+    out->data = it->p + 2;
+    if (out->id == IE_ID_EXTENSION && len > 0) {
+        out->ext_id = out->data[0];
+        out->data++;
+        out->len--;
+    }
+    it->p += 2 + len;
+    return true;
+}
+
+void ie_parse(const uint8_t *ies, size_t len, ie_info_t *out);
+const char *ie_cipher_name(uint8_t suite);
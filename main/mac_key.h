@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*
+ * 48-bit MAC address packed into a uint64 at ingest: byte i of the address
+ * sits in bits 8i..8i+7 (a little-endian load, two loads on RISC-V), the top
+ * 16 bits are zero. Equality is one 64-bit compare; 0 is never a valid
+ * station or BSSID and marks "none".
+ */
+typedef uint64_t mac_key_t;
+
+#define MAC_KEY_NONE ((mac_key_t)0)
+#define MAC_KEY_FMT "%02X:%02X:%02X:%02X:%02X:%02X"
+#define MAC_KEY_ARGS(k) \
+    (unsigned)((k) & 0xFF), (unsigned)(((k) >> 8) & 0xFF), (unsigned)(((k) >> 16) & 0xFF), \
+    (unsigned)(((k) >> 24) & 0xFF), (unsigned)(((k) >> 32) & 0xFF), (unsigned)(((k) >> 40) & 0xFF)
+
+static inline mac_key_t mac_key_from_bytes(const uint8_t *mac) {
+    uint32_t lo;
+    uint16_t hi;
+    memcpy(&lo, mac, 4);
+    memcpy(&hi, mac + 4, 2);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    lo = __builtin_bswap32(lo);
+    hi = __builtin_bswap16(hi);
+#endif
+    return (mac_key_t)lo | ((mac_key_t)hi << 32);
+}
+
+static inline void mac_key_to_bytes(mac_key_t key, uint8_t out[6]) {
+    for (int i = 0; i < 6; i++, key >>= 8) out[i] = (uint8_t)key;
+}
+
+static inline bool mac_key_eq(mac_key_t a, mac_key_t b) {
+    return a == b;
+}
+
+/* Folds the address to 32 bits and mixes it; use the high bits for buckets. */
+static inline uint32_t mac_key_hash(mac_key_t key) {
+    uint32_t h = (uint32_t)key ^ (uint32_t)(key >> 29);
+    return h * 2654435761u;
+}
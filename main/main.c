@@ -2,8 +2,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
-#include <time.h>
-#include <sys/time.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_wifi.h"
@@ -13,7 +12,6 @@
 #include "esp_netif.h"
 #include "esp_mac.h"
 #include "esp_timer.h"
-#include "driver/uart.h"
 #include "esp_system.h"
 #include "esp_heap_caps.h"
 
@@ -21,16 +19,39 @@
 #include "OLEDDisplay.h"
 #include "driver/i2c.h"
 
+#include "scan_snapshot.h"
+#include "ap_history.h"
+#include "ap_table.h"
+#include "arena.h"
+#include "scan_plan.h"
+#include "roam.h"
+#include "ssid_pool.h"
+#include "bloom.h"
+#include "phy_stats.h"
+#include "ie.h"
+#include "hop_plan.h"
+#include "chan_sched.h"
+#include "gps.h"
+
 #define TAG "WiFiScanner"
-#define MAX_APS 10
-#define MAX_CLIENTS 10
+#define SCAN_CHUNK_RECORDS 16
+#define PRINT_PAGE_ROWS 16
+#define CYCLE_ARENA_SIZE (12 * 1024)
 #define SNIFF_TIME_MS 3000
 #define SCAN_INTERVAL_SEC 60
-#define GPS_UART_NUM UART_NUM_1
-#define GPS_RXD 23
-#define GPS_TXD 24
+#define FULL_SCAN_EVERY_N_CYCLES 5   /* in between, only re-probe channels with known APs */
+#define ADAPTIVE_DWELL 1             /* split SNIFF_TIME_MS x dwells by per-channel yield */
+#define SNIFF_MIN_DWELL_MS 1000
+#define HT40_CAPTURE 1               /* tune HT40 when an AP's secondary channel covers more APs */
 #define RETAIN_CLIENTS_HISTORY 1
+#define AP_FILTER_BITS 2048          /* ~2% false positives at 160 APs, k=2 */
+/* Also skip frames from (BSSID, client) pairs already recorded. Off by
+ * default: the roaming detector wants every frame's RSSI and timestamp. */
+#define FILTER_CLIENT_PAIRS 0
+#define PAIR_FILTER_BITS 16384
 #define SORT_RESULTS_BY_RSSI 1
+#define GPS_BOOT_TASK_STACK 4096
+#define GPS_BOOT_TASK_PRIO 4
 
 
 #define _I2C_NUMBER(num) I2C_NUM_0
@@ -42,234 +63,415 @@ SemaphoreHandle_t print_mux = NULL;
 
 
 static void print_memory_stats(void);
+static void print_boot_timeline(void);
 
-static char gps_sentence[128] = {0};
-static float last_lat = 0.0, last_lon = 0.0;
-static bool gps_available = false;
-static bool gps_fix_valid = false;
-static struct tm gps_time_tm = {0};
-static time_t gps_epoch_time = 0;
+/* Scratch memory for one scan cycle (scan chunks, sort keys, print pages,
+ * hop plans). Owned by wifi_scan_task and reset at the top of each cycle. */
+static arena_t cycle_arena;
+static wifi_ap_record_t *scan_chunk = NULL;
 
-bool gps_enabled = false;
+/* Pre-checks for the sniffer callback. Rebuilt only while promiscuous mode
+ * is off, so the callback never sees a half-built filter. */
+static bloom_t ap_filter;
+static bloom_t pair_filter;
+static uint32_t filter_generation = UINT32_MAX;
 
 typedef struct {
-    char ssid[33];
-    uint8_t channel;
-    int rssi;
-    uint8_t bssid[6];
-    int client_count;
-    wifi_auth_mode_t authmode;
-} scan_result_t;
-
-static scan_result_t ap_results[MAX_APS];
-static int ap_result_count = 0;
-static uint8_t client_macs[MAX_APS][MAX_CLIENTS][6];
-static int client_counts[MAX_APS] = {0};
-
-static void init_gps_uart(void) {
-    uart_config_t uart_config = {
-        .baud_rate = 9600,
-        .data_bits = UART_DATA_8_BITS,
-        .parity    = UART_PARITY_DISABLE,
-        .stop_bits = UART_STOP_BITS_1,
-        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE
-    };
-    uart_driver_install(GPS_UART_NUM, 2048, 0, 0, NULL, 0);
-    uart_param_config(GPS_UART_NUM, &uart_config);
-    uart_set_pin(GPS_UART_NUM, GPS_TXD, GPS_RXD, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
-    ESP_LOGI(TAG, "GPS UART initialized on RX=%d, TX=%d", GPS_RXD, GPS_TXD);
+    uint32_t frames;
+    uint32_t filtered;          /* rejected by the BSSID filter */
+    uint32_t false_positives;   /* passed the filter, not in the table */
+    uint32_t known_pairs;       /* skipped by the pair filter */
+    uint32_t pair_false_positives; /* pair filter hits the table did not confirm */
+    uint32_t new_clients;
+    uint32_t beacons;           /* beacons/probe responses from tracked APs */
+} sniff_stats_t;
+
+static sniff_stats_t sniff_stats;
+static hop_yield_t hop_yield;
+
+/* Set by the GPS boot task once a module is detected and configured. */
+static atomic_bool gps_enabled = false;
+
+/* Boot timeline, esp_timer microseconds; 0 = not reached yet. */
+typedef enum {
+    BOOT_NVS,
+    BOOT_HISTORY,
+    BOOT_WIFI,
+    BOOT_SCAN_TASK,
+    BOOT_FIRST_SCAN,
+    BOOT_FIRST_RESULT,
+    BOOT_FIRST_REPORT,
+    BOOT_GPS_DETECTED,
+    BOOT_GPS_READY,
+    BOOT_STAGE_COUNT
+} boot_stage_t;
+
+static const char *const boot_stage_names[BOOT_STAGE_COUNT] = {
+    "NVS", "history", "Wi-Fi", "scan task", "first scan", "first result", "first report",
+    "GPS detected", "GPS ready",
+};
+static int64_t boot_marks[BOOT_STAGE_COUNT];
+
+static void boot_mark(boot_stage_t stage) {
+    if (!boot_marks[stage]) boot_marks[stage] = esp_timer_get_time();
 }
 
-static bool detect_gps_presence(void) {
-    char buffer[128];
-    for (int i = 0; i < 30; i++) {
-        int len = uart_read_bytes(GPS_UART_NUM, (uint8_t *)buffer, sizeof(buffer)-1, 100 / portTICK_PERIOD_MS);
-        if (len > 0) {
-            buffer[len] = '\0';
-            if (strstr(buffer, "$GP")) {
-                printf("GPS detected: YES\n");
-                gps_enabled = true;
-                return true;
-            }
-        }
+/* Chips with 802.11ax (the C5) report the raw SIG fields and a baseband
+ * format instead of the classic sig_mode/mcs/cwb bits. */
+static void phy_sample_from_rx(const wifi_pkt_rx_ctrl_t *rx, phy_sample_t *s) {
+    s->mcs = PHY_MCS_NONE;
+    s->bw = PHY_BW_20;
+    s->noise_floor = rx->noise_floor;
+#if CONFIG_SOC_WIFI_HE_SUPPORT
+    uint32_t siga1 = rx->he_siga1;
+    switch (rx->cur_bb_format) {
+    case RX_BB_FORMAT_HT:
+        s->format = PHY_FMT_HT;
+        s->mcs = siga1 & 0x07;
+        s->bw = (siga1 >> 7) & 1 ? PHY_BW_40 : PHY_BW_20;
+        break;
+    case RX_BB_FORMAT_VHT:
+        s->format = PHY_FMT_VHT;
+        s->mcs = (rx->he_siga2 >> 4) & 0x0F;
+        s->bw = siga1 & 0x03;
+        break;
+    case RX_BB_FORMAT_HE_SU:
+        s->format = PHY_FMT_HE;
+        s->mcs = (siga1 >> 3) & 0x0F;
+        s->bw = (siga1 >> 19) & 0x03;
+        break;
+    case RX_BB_FORMAT_HE_MU: {
+        /* 4-7 are preamble-punctured 80 and 160 MHz. */
+        uint8_t bw = (siga1 >> 15) & 0x07;
+        s->format = PHY_FMT_HE;
+        s->bw = bw < 4 ? bw : (bw < 6 ? PHY_BW_80 : PHY_BW_160);
+        break;
+    }
+    case RX_BB_FORMAT_HE_ERSU:
+    case RX_BB_FORMAT_HE_TB:
+        s->format = PHY_FMT_HE;
+        break;
+    default:
+        s->format = PHY_FMT_LEGACY;
+        break;
     }
-    printf("No GPS data detected - disabling GPS support\n");
-    gps_enabled = false;
-    return false;
+#else
+    switch (rx->sig_mode) {
+    case 1:
+        s->format = PHY_FMT_HT;
+        s->mcs = rx->mcs & 0x07;
+        s->bw = rx->cwb ? PHY_BW_40 : PHY_BW_20;
+        break;
+    case 3:
+        s->format = PHY_FMT_VHT;
+        s->mcs = rx->mcs & 0x0F;
+        s->bw = rx->cwb ? PHY_BW_40 : PHY_BW_20;
+        break;
+    default:
+        s->format = PHY_FMT_LEGACY;
+        break;
+    }
+#endif
+    if (s->mcs >= PHY_MCS_BINS) s->mcs = PHY_MCS_NONE;
 }
 
-static void send_gps_command(const char *cmd) {
-    const char *newline = "\r\n";
-    uart_write_bytes(GPS_UART_NUM, cmd, strlen(cmd));
-    uart_write_bytes(GPS_UART_NUM, newline, 2);
-    ESP_LOGI(TAG, "Sent GPS command: %s", cmd);
+#define MGMT_HEADER_LEN 24
+#define FCS_LEN 4
+
+static void sniff_beacon(const wifi_promiscuous_pkt_t *pkt) {
+    const uint8_t *frame = pkt->payload;
+    uint8_t subtype = frame[0] & 0xFC;
+    if (subtype != 0x80 && subtype != 0x50) return;    /* beacon, probe response */
+
+    int len = (int)pkt->rx_ctrl.sig_len - FCS_LEN - MGMT_HEADER_LEN - IE_BEACON_FIXED_LEN;
+    if (len <= 0) return;
+    mac_key_t bssid = mac_key_from_bytes(frame + 16);
+    if (!bloom_maybe(&ap_filter, bssid)) return;
+    int slot = ap_table_find(bssid);
+    if (slot < 0) return;
+    ap_table_locate(slot, gps_track_ref(), pkt->rx_ctrl.rssi);
+
+    ap_cold_t *cold = ap_table_cold(slot);
+    ie_parse(frame + MGMT_HEADER_LEN + IE_BEACON_FIXED_LEN, len, &cold->ie);
+    cold->ie_valid = true;
+    sniff_stats.beacons++;
 }
 
-static void parse_gprmc(const char *nmea) {
-    char buf[128];
-    strncpy(buf, nmea, sizeof(buf) - 1);
-    buf[sizeof(buf) - 1] = '\0';
-
-    char *tokens[15] = {0};
-    char *p = strtok(buf, ",");
-    int idx = 0;
-    while (p && idx < 15) {
-        tokens[idx++] = p;
-        p = strtok(NULL, ",");
+#define FC_TO_DS 0x01               /* frame control, second byte */
+#define FC_FROM_DS 0x02
+
+/*
+ * BSSID and station of an infrastructure data frame. ToDS frames go from
+ * the station to the AP (addr1 = BSSID, addr2 = station), FromDS frames the
+ * other way (addr1 = station, addr2 = BSSID); addr3 is the far end behind
+ * the AP, e.g. the gateway, and never the station. Ad-hoc, WDS and
+ * group-addressed frames name no single station and are skipped.
+ */
+static bool data_frame_link(const uint8_t *payload, mac_key_t *bssid, mac_key_t *client) {
+    switch (payload[1] & (FC_TO_DS | FC_FROM_DS)) {
+    case FC_TO_DS:
+        *bssid = mac_key_from_bytes(payload + 4);
+        *client = mac_key_from_bytes(payload + 10);
+        return true;
+    case FC_FROM_DS:
+        if (payload[4] & 0x01) return false;
+        *client = mac_key_from_bytes(payload + 4);
+        *bssid = mac_key_from_bytes(payload + 10);
+        return true;
+    default:
+        return false;
     }
-
-    if (idx < 10 || tokens[1] == NULL || tokens[9] == NULL) return;
-
-    char *time_str = tokens[1];
-    char *date_str = tokens[9];
-
-    if (strlen(time_str) < 6 || strlen(date_str) != 6) return;
-
-    int hh = (time_str[0] - '0') * 10 + (time_str[1] - '0');
-    int mm = (time_str[2] - '0') * 10 + (time_str[3] - '0');
-    int ss = (time_str[4] - '0') * 10 + (time_str[5] - '0');
-
-    int dd = (date_str[0] - '0') * 10 + (date_str[1] - '0');
-    int mo = (date_str[2] - '0') * 10 + (date_str[3] - '0');
-    int yy = (date_str[4] - '0') * 10 + (date_str[5] - '0');
-
-    gps_time_tm.tm_year = yy + 100;
-    gps_time_tm.tm_mon = mo - 1;
-    gps_time_tm.tm_mday = dd;
-    gps_time_tm.tm_hour = hh;
-    gps_time_tm.tm_min = mm;
-    gps_time_tm.tm_sec = ss;
-    gps_time_tm.tm_isdst = 0;
-
-    gps_epoch_time = mktime(&gps_time_tm);
-    struct timeval tv = {
-        .tv_sec = gps_epoch_time,
-        .tv_usec = 0
-    };
-    settimeofday(&tv, NULL);
-
-    ESP_LOGI(TAG, "RTC updated from GPS: %04d-%02d-%02d %02d:%02d:%02d",
-             gps_time_tm.tm_year + 1900, gps_time_tm.tm_mon + 1, gps_time_tm.tm_mday,
-             gps_time_tm.tm_hour, gps_time_tm.tm_min, gps_time_tm.tm_sec);
 }
 
-static void parse_gpgga(const char *nmea) {
-    char buf[128];
-    strncpy(buf, nmea, sizeof(buf) - 1);
-    buf[sizeof(buf) - 1] = '\0';
-
-    char *tokens[15] = {0};
-    char *p = strtok(buf, ",");
-    int idx = 0;
-    while (p && idx < 15) {
-        tokens[idx++] = p;
-        p = strtok(NULL, ",");
+static void wifi_sniffer_callback(void *buf, wifi_promiscuous_pkt_type_t type) {
+    const wifi_promiscuous_pkt_t *pkt = (wifi_promiscuous_pkt_t *)buf;
+    if (type == WIFI_PKT_MGMT) {
+        sniff_beacon(pkt);
+        return;
     }
+    if (type != WIFI_PKT_DATA || pkt->rx_ctrl.sig_len < MGMT_HEADER_LEN) return;
 
-    if (idx < 7 || !tokens[2] || !tokens[3] || !tokens[4] || !tokens[5] || !tokens[6]) {
-        gps_fix_valid = false;
+    mac_key_t bssid, client;
+    if (!data_frame_link(pkt->payload, &bssid, &client)) return;
+
+    sniff_stats.frames++;
+    if (!bloom_maybe(&ap_filter, bssid)) {
+        sniff_stats.filtered++;
         return;
     }
-
-    if (tokens[6][0] == '0') {
-        gps_fix_valid = false;
+    int slot = ap_table_find(bssid);
+    if (slot < 0) {
+        sniff_stats.false_positives++;
         return;
     }
 
-    float lat = atof(tokens[2]);
-    float lon = atof(tokens[4]);
+    /* The rate of the AP-station link: picked by the AP for the station on
+     * FromDS frames, by the station itself on ToDS; both bound what it supports. */
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    phy_sample_t sample;
+    phy_sample_from_rx(&pkt->rx_ctrl, &sample);
+    phy_stats_observe(slot, bssid, client, &sample, now_ms);
+#if FILTER_CLIENT_PAIRS
+    /* A hit can be a false positive; skip only pairs the table confirms,
+     * so a new client is never dropped. */
+    mac_key_t pair = bssid ^ (client * 0xFF51AFD7ED558CCDull);
+    if (bloom_maybe(&pair_filter, pair)) {
+        if (ap_table_has_client(slot, client)) {
+            sniff_stats.known_pairs++;
+            return;
+        }
+        sniff_stats.pair_false_positives++;
+    } else {
+        bloom_add(&pair_filter, pair);
+    }
+#endif
 
-    int lat_deg = (int)(lat / 100);
-    float lat_min = lat - (lat_deg * 100);
-    last_lat = lat_deg + (lat_min / 60.0);
-    if (tokens[3][0] == 'S') last_lat *= -1;
+    if (ap_table_add_client(slot, client, gps_track_ref())) sniff_stats.new_clients++;
+    roam_observe(client, bssid, ap_table_cold(slot)->ess_id, pkt->rx_ctrl.rssi, now_ms);
+}
 
-    int lon_deg = (int)(lon / 100);
-    float lon_min = lon - (lon_deg * 100);
-    last_lon = lon_deg + (lon_min / 60.0);
-    if (tokens[5][0] == 'W') last_lon *= -1;
+static void rebuild_frame_filters(void) {
+    if (ap_table_generation() == filter_generation) return;
+    filter_generation = ap_table_generation();
+
+    bloom_clear(&ap_filter);
+#if FILTER_CLIENT_PAIRS
+    bloom_clear(&pair_filter);
+#endif
+    for (int i = 0; i < ap_table_count(); i++) {
+        int slot = ap_table_slot_at(i);
+        mac_key_t bssid = ap_table_bssid(slot);
+        bloom_add(&ap_filter, bssid);
+#if FILTER_CLIENT_PAIRS
+        const ap_cold_t *cold = ap_table_cold(slot);
+        for (int c = 0; c < ap_table_client_count(slot); c++) {
+            bloom_add(&pair_filter, bssid ^ (cold->clients[c] * 0xFF51AFD7ED558CCDull));
+        }
+#endif
+    }
+}
 
-    gps_fix_valid = true;
+static void print_sniff_stats(void) {
+    uint32_t probed = sniff_stats.frames - sniff_stats.filtered;
+    printf("Frame filter: %u data frames, %u rejected by BSSID filter (%u%%), %u probed, %u false positives",
+           (unsigned)sniff_stats.frames, (unsigned)sniff_stats.filtered,
+           sniff_stats.frames ? (unsigned)(100ull * sniff_stats.filtered / sniff_stats.frames) : 0,
+           (unsigned)probed, (unsigned)sniff_stats.false_positives);
+#if FILTER_CLIENT_PAIRS
+    printf(", %u known pairs skipped, %u pair filter false positives",
+           (unsigned)sniff_stats.known_pairs, (unsigned)sniff_stats.pair_false_positives);
+#endif
+    printf("\n");
+    printf("Beacons: %u from tracked APs parsed\n", (unsigned)sniff_stats.beacons);
+}
 
-    if (tokens[7]) {
-        int sat_count = atoi(tokens[7]);
-        ESP_LOGI(TAG, "Satellites in use: %d", sat_count);
+/* Pulls the driver's scan list a chunk at a time so a large scan never needs
+ * a full-size record array on the stack. */
+static void collect_scan_records(void) {
+    uint16_t ap_num = 0;
+    esp_wifi_scan_get_ap_num(&ap_num);
+    ap_table_reserve(ap_table_count() + ap_num);
+
+    wifi_ap_record_t *chunk = scan_chunk;
+    int remaining = ap_num;
+    while (remaining > 0) {
+        int n = 0;
+        while (n < SCAN_CHUNK_RECORDS && remaining > 0 && esp_wifi_scan_get_ap_record(&chunk[n]) == ESP_OK) {
+            n++;
+            remaining--;
+        }
+        if (n == 0) break;
+        ap_table_merge(chunk, n, gps_track_ref());
     }
+    esp_wifi_clear_ap_list();
+}
+
+static void publish_scan_snapshot(void) {
+    scan_snapshot_t *snap = scan_snapshot_begin();
+    int n = ap_table_count() < snap->capacity ? ap_table_count() : snap->capacity;
 
-    ESP_LOGI(TAG, "Parsed GPS: %.5f, %.5f", last_lat, last_lon);
+    ap_order_t *order = arena_alloc(&cycle_arena, n * sizeof(ap_order_t));
+    ap_table_order(order, n, SORT_RESULTS_BY_RSSI);
+    for (int i = 0; i < n; i++) {
+        ap_table_fill_row(order[i].slot, &snap->rows[i]);
+    }
+    snap->info.count = n;
+    scan_snapshot_publish();
 }
 
-static void poll_gps_data(void) {
-    if (!gps_available) return;
-
-    int len = uart_read_bytes(GPS_UART_NUM, (uint8_t *)gps_sentence, sizeof(gps_sentence) - 1, 0);
-    if (len > 0) {
-        gps_sentence[len] = '\0';
-        //ESP_LOGI(TAG, "RAW GPS: %s", gps_sentence);
-
-        char *saveptr;
-        char *line = strtok_r(gps_sentence, "\r\n", &saveptr);
-        while (line) {
-            if (strstr(line, "GGA")) {
-                //ESP_LOGI(TAG, "GGA detected: %s", line);
-                parse_gpgga(line);
-            } else if (strstr(line, "RMC")) {
-                ESP_LOGI(TAG, "RMC detected: %s", line);
-                if (strchr(line, '*')) {
-                    parse_gprmc(line);
-                } else {
-                    //ESP_LOGW(TAG, "Ignored partial RMC line: %s", line);
-                }
-            }
-            line = strtok_r(NULL, "\r\n", &saveptr);
+static void log_scan_history(void) {
+    scan_result_t row;
+    for (int i = 0; i < ap_table_count(); i++) {
+        int slot = ap_table_slot_at(i);
+        const ap_cold_t *cold = ap_table_cold(slot);
+        ap_table_fill_row(slot, &row);
+        ap_history_log_ap(&row, cold->seen_at);
+        for (int c = 0; c < ap_table_client_count(slot); c++) {
+            ap_history_log_client(row.bssid, cold->clients[c], cold->client_seen_at[c]);
         }
     }
 }
 
-static bool mac_in_list(uint8_t (*list)[6], int count, const uint8_t *mac) {
+static const char *auth_mode_name(wifi_auth_mode_t authmode) {
+    switch (authmode) {
+        case WIFI_AUTH_WEP: return "WEP";
+        case WIFI_AUTH_WPA_PSK: return "WPA";
+        case WIFI_AUTH_WPA2_PSK: return "WPA2";
+        case WIFI_AUTH_WPA_WPA2_PSK: return "WPA/WPA2";
+        case WIFI_AUTH_WPA3_PSK: return "WPA3";
+        case WIFI_AUTH_WPA2_WPA3_PSK: return "WPA2/WPA3";
+        default: return "OPEN";
+    }
+}
+
+static void print_ess_view(void) {
+    ess_summary_t *view = arena_alloc(&cycle_arena, ap_table_count() * sizeof(ess_summary_t));
+    int count = ap_table_build_ess_view(view, ap_table_count());
+
+    printf("\n| %-25s | %-10s | %-5s | %-7s | %-4s | %-6s |\n",
+           "Network", "Security", "BSSID", "Bands", "Cli", "Best");
+    printf("|---------------------------|------------|-------|---------|------|--------|\n");
     for (int i = 0; i < count; i++) {
-        if (memcmp(list[i], mac, 6) == 0) {
-            return true;
-        }
+        const char *ssid = ssid_pool_get(view[i].ssid_id);
+        const char *bands = view[i].bands == 3 ? "2.4G+5G" : (view[i].bands & 1) ? "2.4G" : "5G";
+        printf("| %-25s | %-10s | %-5u | %-7s | %-4u | %-6d |\n",
+               ssid[0] ? ssid : "<hidden>", auth_mode_name(view[i].authmode), view[i].bssids,
+               bands, view[i].clients, view[i].best_rssi);
     }
-    return false;
 }
 
-static void wifi_sniffer_callback(void *buf, wifi_promiscuous_pkt_type_t type) {
-    if (type != WIFI_PKT_DATA) return;
-    const wifi_promiscuous_pkt_t *pkt = (wifi_promiscuous_pkt_t *)buf;
-    const uint8_t *payload = pkt->payload;
-
-    const uint8_t *bssid = payload + 10;
-    const uint8_t *src = payload + 16;
-
-    for (int i = 0; i < ap_result_count; i++) {
-        if (memcmp(ap_results[i].bssid, bssid, 6) == 0) {
-            if (!mac_in_list(client_macs[i], client_counts[i], src) && client_counts[i] < MAX_CLIENTS) {
-                memcpy(client_macs[i][client_counts[i]], src, 6);
-                client_counts[i]++;
-                ap_results[i].client_count = client_counts[i];
-            }
-            break;
+static void print_ap_capabilities(void) {
+    printf("\n| %-17s | %-3s | %-11s | %-5s | %-8s | %-7s | %-7s | %-9s |\n",
+           "BSSID", "Ch", "PHY", "Width", "PMF", "Cipher", "Country", "Load");
+    printf("|-------------------|-----|-------------|-------|----------|---------|---------|-----------|\n");
+    for (int i = 0; i < ap_table_count(); i++) {
+        int slot = ap_table_slot_at(i);
+        const ap_cold_t *cold = ap_table_cold(slot);
+        if (!cold->ie_valid) continue;
+
+        const ie_info_t *ie = &cold->ie;
+        char phy[16], load[16];
+        snprintf(phy, sizeof(phy), "%s%s%s",
+                 (ie->flags & IE_HAS_HT) ? "HT " : "", (ie->flags & IE_HAS_VHT) ? "VHT " : "",
+                 (ie->flags & IE_HAS_HE) ? "HE" : "");
+        if (ie->flags & IE_HAS_BSS_LOAD) {
+            snprintf(load, sizeof(load), "%u sta %u%%", ie->station_count, ie->channel_util * 100 / 255);
+        } else {
+            snprintf(load, sizeof(load), "-");
         }
+        const char *pmf = ie->pmf == IE_PMF_REQUIRED ? "required" : ie->pmf == IE_PMF_CAPABLE ? "capable" : "-";
+        printf("| " MAC_KEY_FMT " | %-3d | %-11s | %-5u | %-8s | %-7s | %-7s | %-9s |\n",
+               MAC_KEY_ARGS(ap_table_bssid(slot)), ap_table_channel(slot), phy[0] ? phy : "legacy",
+               ie->width_mhz, pmf, (ie->flags & IE_HAS_RSN) ? ie_cipher_name(ie->group_cipher) : "-",
+               (ie->flags & IE_HAS_COUNTRY) ? ie->country : "-", load);
     }
 }
 
+static void print_ap_locations(void) {
+    printf("\n| %-17s | %-7s | %-12s | %-12s | %-7s | %-4s | %-12s | %-12s |\n",
+           "BSSID", "Samples", "Est. lat", "Est. lon", "Radius", "Best", "Best lat", "Best lon");
+    printf("|-------------------|---------|--------------|--------------|---------|------|--------------|--------------|\n");
+    for (int i = 0; i < ap_table_count(); i++) {
+        int slot = ap_table_slot_at(i);
+        const ap_locate_t *loc = &ap_table_cold(slot)->loc;
+        ap_locate_estimate_t est;
+        if (!ap_locate_estimate(loc, &est)) continue;
+
+        char lat[16], lon[16], best_lat[16], best_lon[16], radius[16];
+        gps_format_coord(est.lat_e7, lat, sizeof(lat));
+        gps_format_coord(est.lon_e7, lon, sizeof(lon));
+        gps_format_coord(loc->best_lat_e7, best_lat, sizeof(best_lat));
+        gps_format_coord(loc->best_lon_e7, best_lon, sizeof(best_lon));
+        snprintf(radius, sizeof(radius), "%u m", (unsigned)est.radius_m);
+        printf("| " MAC_KEY_FMT " | %-7u | %-12s | %-12s | %-7s | %-4d | %-12s | %-12s |\n",
+               MAC_KEY_ARGS(ap_table_bssid(slot)), loc->samples, lat, lon, radius,
+               loc->best_rssi, best_lat, best_lon);
+    }
+}
 
+static void print_roam_events(void) {
+    roam_event_t ev;
+    while (roam_pop_event(&ev)) {
+        printf("Roam: " MAC_KEY_FMT "  " MAC_KEY_FMT " -> " MAC_KEY_FMT "  after %u ms, RSSI %d -> %d\n",
+               MAC_KEY_ARGS(ev.client), MAC_KEY_ARGS(ev.from), MAC_KEY_ARGS(ev.to),
+               (unsigned)ev.delta_ms, ev.rssi_before, ev.rssi_after);
+    }
 
-
-static int compare_rssi(const void *a, const void *b) {
-    const scan_result_t *ra = (const scan_result_t *)a;
-    const scan_result_t *rb = (const scan_result_t *)b;
-    return rb->rssi - ra->rssi;
+    roam_stats_t stats;
+    roam_get_stats(&stats);
+    printf("Roaming: %u clients tracked, %u evicted, %u roams, %u events dropped\n",
+           (unsigned)stats.tracked, (unsigned)stats.evicted, (unsigned)stats.roams, (unsigned)stats.events_dropped);
 }
 
-static void print_scan_results(void) {
-    if (SORT_RESULTS_BY_RSSI && ap_result_count > 1) {
-        qsort(ap_results, ap_result_count, sizeof(scan_result_t), compare_rssi);
+static void print_scan_row(const scan_result_t *row, bool with_gps) {
+    const char *band = (row->channel <= 14) ? "2.4G" : "5G";
+    const char *auth_mode = auth_mode_name(row->authmode);
+
+    if (with_gps) {
+        char lat_buf[16], lon_buf[16];
+        if (row->located) {
+            gps_format_coord(row->lat_e7, lat_buf, sizeof(lat_buf));
+            gps_format_coord(row->lon_e7, lon_buf, sizeof(lon_buf));
+        } else {
+            snprintf(lat_buf, sizeof(lat_buf), "No fix");
+            snprintf(lon_buf, sizeof(lon_buf), "No fix");
+        }
+        const char *fix_status = row->located ? "OK" : "NOFIX";
+
+        printf("| %-25s | %-4s | %-5d | %-6d | %-4d | " MAC_KEY_FMT " | %-10s | %-12s | %-12s | %-7s |\n",
+               row->ssid, band, row->channel, row->rssi, row->client_count, MAC_KEY_ARGS(row->bssid),
+               auth_mode, lat_buf, lon_buf, fix_status);
+    } else {
+        printf("| %-25s | %-4s | %-5d | %-6d | %-4d | " MAC_KEY_FMT " | %-10s |\n",
+               row->ssid, band, row->channel, row->rssi, row->client_count, MAC_KEY_ARGS(row->bssid),
+               auth_mode);
     }
+}
 
-    if (gps_enabled) {
+static void print_scan_results(void) {
+    /* GPS can come up mid-print; keep the header and rows consistent. */
+    bool with_gps = gps_enabled;
+    if (with_gps) {
         printf("\n| %-25s | %-4s | %-5s | %-6s | %-4s | %-17s | %-10s | %-12s | %-12s | %-7s |\n",
                "SSID", "Band", "Chan", "RSSI", "Cli", "BSSID", "Security", "Latitude", "Longitude", "GPS Fix");
         printf("|---------------------------|------|-------|--------|------|-------------------|------------|--------------|--------------|---------|\n");
@@ -279,91 +481,129 @@ static void print_scan_results(void) {
         printf("|---------------------------|------|-------|--------|------|-------------------|------------|\n");
     }
 
-    for (int i = 0; i < ap_result_count; i++) {
-        const char *band = (ap_results[i].channel <= 14) ? "2.4G" : "5G";
-        const char *auth_mode = "OPEN";
-        switch (ap_results[i].authmode) {
-            case WIFI_AUTH_WEP: auth_mode = "WEP"; break;
-            case WIFI_AUTH_WPA_PSK: auth_mode = "WPA"; break;
-            case WIFI_AUTH_WPA2_PSK: auth_mode = "WPA2"; break;
-            case WIFI_AUTH_WPA_WPA2_PSK: auth_mode = "WPA/WPA2"; break;
-            case WIFI_AUTH_WPA3_PSK: auth_mode = "WPA3"; break;
-            case WIFI_AUTH_WPA2_WPA3_PSK: auth_mode = "WPA2/WPA3"; break;
-            default: break;
-        }
-
-        if (gps_enabled) {
-            char lat_buf[16], lon_buf[16];
-            snprintf(lat_buf, sizeof(lat_buf), gps_fix_valid ? "%.5f" : "No fix", last_lat);
-            snprintf(lon_buf, sizeof(lon_buf), gps_fix_valid ? "%.5f" : "No fix", last_lon);
-            const char *fix_status = gps_fix_valid ? "OK" : "NOFIX";
-
-            printf("| %-25s | %-4s | %-5d | %-6d | %-4d | %02X:%02X:%02X:%02X:%02X:%02X | %-10s | %-12s | %-12s | %-7s |\n",
-                   ap_results[i].ssid, band, ap_results[i].channel, ap_results[i].rssi, ap_results[i].client_count,
-                   ap_results[i].bssid[0], ap_results[i].bssid[1], ap_results[i].bssid[2],
-                   ap_results[i].bssid[3], ap_results[i].bssid[4], ap_results[i].bssid[5],
-                   auth_mode, lat_buf, lon_buf, fix_status);
-        } else {
-            printf("| %-25s | %-4s | %-5d | %-6d | %-4d | %02X:%02X:%02X:%02X:%02X:%02X | %-10s |\n",
-                   ap_results[i].ssid, band, ap_results[i].channel, ap_results[i].rssi, ap_results[i].client_count,
-                   ap_results[i].bssid[0], ap_results[i].bssid[1], ap_results[i].bssid[2],
-                   ap_results[i].bssid[3], ap_results[i].bssid[4], ap_results[i].bssid[5],
-                   auth_mode);
+    /* Page through the snapshot; stop if a newer one is published mid-print. */
+    scan_result_t *rows = arena_alloc(&cycle_arena, PRINT_PAGE_ROWS * sizeof(scan_result_t));
+    scan_snapshot_info_t info;
+    uint32_t version = 0;
+    int first = 0;
+    while (1) {
+        int row_count = scan_snapshot_read(&info, rows, first, PRINT_PAGE_ROWS);
+        if (first == 0) version = info.version;
+        if (row_count == 0 || info.version != version) break;
+        for (int i = 0; i < row_count; i++) {
+            print_scan_row(&rows[i], with_gps);
         }
+        first += row_count;
     }
 }
 
 
 void wifi_scan_task(void *pvParameters) {
-    wifi_scan_config_t scan_cfg = {
-        .ssid = NULL,
-        .bssid = NULL,
-        .channel = 0,
-        .show_hidden = true
-    };
-    
+    const scan_plan_t *plan = scan_plan_default();
+    scan_plan_report_t scan_report;
+    channel_mask_t scanned, known;
+    uint32_t cycle = 0, full_sweeps = 0;
+
+    boot_mark(BOOT_SCAN_TASK);
     while (1) {
-        poll_gps_data();
+        arena_reset(&cycle_arena);
+        scan_chunk = arena_alloc(&cycle_arena, SCAN_CHUNK_RECORDS * sizeof(wifi_ap_record_t));
         esp_wifi_set_promiscuous(false);
-        esp_wifi_scan_start(&scan_cfg, true);
-
-        wifi_ap_record_t results[MAX_APS] = {0};
-        uint16_t count = MAX_APS;
-        if (esp_wifi_scan_get_ap_records(&count, results) == ESP_OK) {
-            ap_result_count = 0;
-            for (int i = 0; i < count && ap_result_count < MAX_APS; i++) {
-                scan_result_t *entry = &ap_results[ap_result_count];
-                strncpy(entry->ssid, (char *)results[i].ssid, sizeof(entry->ssid) - 1);
-                entry->ssid[32] = '\0';
-                entry->channel = results[i].primary;
-                entry->rssi = results[i].rssi;
-                memcpy(entry->bssid, results[i].bssid, 6);
-                entry->authmode = results[i].authmode;
-                if (!RETAIN_CLIENTS_HISTORY) {
-                    memset(client_macs[ap_result_count], 0, sizeof(client_macs[ap_result_count]));
-                    client_counts[ap_result_count] = 0;
-                }
-                entry->client_count = client_counts[ap_result_count];
-                ap_result_count++;
-            }
+
+        ap_table_begin_update(!RETAIN_CLIENTS_HISTORY);
+        if (cycle++ % FULL_SCAN_EVERY_N_CYCLES == 0 || ap_table_count() == 0) {
+            scan_plan_run(plan, full_sweeps++, NULL, collect_scan_records, &scan_report, &scanned);
+        } else {
+            ap_table_get_channels(&known);
+            scan_plan_run(plan, 0, &known, collect_scan_records, &scan_report, &scanned);
+        }
+        ap_table_end_update(&scanned);
+        rebuild_frame_filters();
+        if (!boot_marks[BOOT_FIRST_SCAN]) {
+            /* Show the first scan right away rather than after the sniff dwells. */
+            boot_mark(BOOT_FIRST_SCAN);
+            publish_scan_snapshot();
+            boot_mark(BOOT_FIRST_RESULT);
+        }
+        memset(&sniff_stats, 0, sizeof(sniff_stats));
+
+        int ap_count = ap_table_count();
+        hop_ap_t *hop_aps = arena_alloc(&cycle_arena, ap_count * sizeof(hop_ap_t));
+        hop_dwell_t *dwells = arena_alloc(&cycle_arena, ap_count * sizeof(hop_dwell_t));
+        for (int i = 0; i < ap_count; i++) {
+            int slot = ap_table_slot_at(i);
+            hop_aps[i].channel = ap_table_channel(slot);
+            hop_aps[i].second = ap_table_second(slot);
         }
+        int dwell_count = hop_plan_build(hop_aps, ap_count, HT40_CAPTURE, dwells);
+
+        uint8_t *dwell_channels = arena_alloc(&cycle_arena, ap_count);
+        uint8_t *dwell_seconds = arena_alloc(&cycle_arena, ap_count);
+        uint32_t *dwell_ms = arena_alloc(&cycle_arena, ap_count * sizeof(uint32_t));
+        for (int d = 0; d < dwell_count; d++) {
+            dwell_channels[d] = dwells[d].channel;
+            dwell_seconds[d] = dwells[d].second;
+            dwell_ms[d] = SNIFF_TIME_MS;
+        }
+#if ADAPTIVE_DWELL
+        chan_sched_allocate(dwell_channels, dwell_seconds, dwell_count, dwell_count * SNIFF_TIME_MS,
+                            SNIFF_MIN_DWELL_MS, dwell_ms);
+#endif
 
         esp_wifi_set_promiscuous_rx_cb(wifi_sniffer_callback);
         esp_wifi_set_promiscuous(true);
 
-        for (int i = 0; i < ap_result_count; i++) {
-            esp_wifi_set_channel(ap_results[i].channel, WIFI_SECOND_CHAN_NONE);
-            vTaskDelay(pdMS_TO_TICKS(SNIFF_TIME_MS));
+        for (int d = 0; d < dwell_count; d++) {
+            uint32_t accepted = sniff_stats.frames - sniff_stats.filtered - sniff_stats.false_positives;
+            uint32_t new_clients = sniff_stats.new_clients;
+            esp_wifi_set_channel(dwells[d].channel, dwells[d].second);
+            vTaskDelay(pdMS_TO_TICKS(dwell_ms[d]));
+            new_clients = sniff_stats.new_clients - new_clients;
+            hop_yield_add(&hop_yield, &dwells[d],
+                          sniff_stats.frames - sniff_stats.filtered - sniff_stats.false_positives - accepted,
+                          new_clients);
+            chan_sched_update(dwells[d].channel, dwells[d].second, dwell_ms[d], new_clients);
         }
 
         esp_wifi_set_promiscuous(false);
+        publish_scan_snapshot();
+        log_scan_history();
         print_scan_results();
+        print_ess_view();
+        print_ap_capabilities();
+        if (gps_enabled) print_ap_locations();
+        print_roam_events();
+        print_sniff_stats();
+        phy_stats_print_report();
+        scan_plan_print_report(&scan_report);
+        hop_plan_print_report(dwells, dwell_count, &hop_yield);
+#if ADAPTIVE_DWELL
+        chan_sched_print_report();
+#endif
         print_memory_stats();
+        ap_history_print_stats();
+        if (gps_enabled) gps_print_stats();
+        if (!boot_marks[BOOT_FIRST_REPORT]) {
+            boot_mark(BOOT_FIRST_REPORT);
+            print_boot_timeline();
+        }
         printf("Next scan in %d seconds...\n", SCAN_INTERVAL_SEC);
         vTaskDelay(pdMS_TO_TICKS(SCAN_INTERVAL_SEC * 1000));
     }
 }
 
+static void print_boot_timeline(void) {
+    printf("Boot timeline (ms since boot):");
+    for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+        if (boot_marks[i]) {
+            printf(" %s %lld,", boot_stage_names[i], (long long)(boot_marks[i] / 1000));
+        } else {
+            printf(" %s -,", boot_stage_names[i]);
+        }
+    }
+    printf(" time to first result %lld ms\n", (long long)(boot_marks[BOOT_FIRST_RESULT] / 1000));
+}
+
 static void print_memory_stats(void) {
     size_t free = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
     size_t total = heap_caps_get_total_size(MALLOC_CAP_DEFAULT);
@@ -371,6 +611,23 @@ static void print_memory_stats(void) {
     float used_pct = ((float)used / total) * 100.0f;
 
     printf("Memory: used %zu / %zu bytes (%.1f%% used)\n", used, total, used_pct);
+
+    printf("Cycle arena: %zu / %zu bytes this cycle (last %zu), high-water %zu\n",
+           cycle_arena.used, cycle_arena.size, cycle_arena.last_cycle_used,
+           cycle_arena.high_water);
+
+    ap_table_stats_t table;
+    ap_table_get_stats(&table);
+    printf("AP table: %d / %d slots (cap %d), peak %d APs, %zu bytes/AP, peak %zu bytes, pool %zu bytes\n",
+           table.count, table.capacity, table.max_aps, table.peak_count, table.bytes_per_ap,
+           table.peak_count * table.bytes_per_ap, table.pool_bytes);
+    printf("AP table: %d missing from last scan (kept), %u retired after %d misses\n",
+           table.missing, (unsigned)table.retired, AP_RETIRE_AFTER_MISSES);
+
+    ssid_pool_stats_t ssids;
+    ssid_pool_get_stats(&ssids);
+    printf("SSID pool: %d unique / %d refs, %zu bytes, saves %ld bytes per 100 APs\n",
+           ssids.unique, ssids.refs, ssids.pool_bytes, table.ssid_saving_per_100);
 }
 
 
@@ -383,32 +640,50 @@ static void i2c_small_text_list(void *arg)
 
 	int page = 0;			 
 	int networks_per_page = 4; 
+	scan_result_t rows[4];
+	scan_snapshot_info_t info;
 
 	while (1)
 	{
+		int shown = scan_snapshot_read(&info, rows, page * networks_per_page, networks_per_page);
+
 		OLEDDisplay_clear(oled);         
         OLEDDisplay_drawString(oled, 0, 00, "Networks");
 
-		for (int i = 0; i < networks_per_page; i++)
+		for (int i = 0; i < shown; i++)
 		{
-			int index = page * networks_per_page + i;
-			if (index < ap_result_count)
-			{
-				OLEDDisplay_drawString(oled, 0, 15 + (i * 10), ap_results[index].ssid);
-			}
+			OLEDDisplay_drawString(oled, 0, 15 + (i * 10), rows[i].ssid);
 		}
 
 		OLEDDisplay_display(oled);			  
 		vTaskDelay(8000 / portTICK_PERIOD_MS); 
 
 		page++;
-		if (page * networks_per_page >= ap_result_count)
+		if (page * networks_per_page >= info.count)
 		{
 			page = 0; 
 		}
 	}
 }
 
+/* Detection blocks for up to 3 s and negotiation for longer; neither holds up the scanner. */
+static void gps_boot_task(void *arg) {
+    printf("Detecting GPS module...\n");
+    if (gps_detect()) {
+        boot_mark(BOOT_GPS_DETECTED);
+        if (!gps_configure()) {
+            printf("GPS lost during configuration - disabling GPS support\n");
+        } else if (gps_start() == ESP_OK) {
+            gps_enabled = true;
+            boot_mark(BOOT_GPS_READY);
+            printf("GPS ready %lld ms after boot\n", (long long)(boot_marks[BOOT_GPS_READY] / 1000));
+        } else {
+            ESP_LOGE(TAG, "Could not start GPS task");
+        }
+    }
+    vTaskDelete(NULL);
+}
+
 void app_main(void) {
     printf("==== ESP32 WiFi Scanner Startup ====\n");
     esp_log_level_set("*", ESP_LOG_WARN);
@@ -418,6 +693,13 @@ void app_main(void) {
 
     printf("Initializing NVS storage...\n");
     ESP_ERROR_CHECK(nvs_flash_init());
+    boot_mark(BOOT_NVS);
+
+    printf("Opening AP history partition...\n");
+    if (ap_history_init() != ESP_OK) {
+        printf("AP history unavailable - running without persistence\n");
+    }
+    boot_mark(BOOT_HISTORY);
 
     printf("Initializing network interface...\n");
     ESP_ERROR_CHECK(esp_netif_init());
@@ -426,19 +708,31 @@ void app_main(void) {
     ESP_ERROR_CHECK(esp_event_loop_create_default());
 
     printf("Initializing GPS UART...\n");
-    init_gps_uart();
+    ESP_ERROR_CHECK(gps_init());
 
-    printf("Detecting GPS module...\n");
-    gps_available = detect_gps_presence();
-    if (gps_available) {
-        send_gps_command("$PMTK314,0,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0*28");
-    } 
+    xTaskCreate(gps_boot_task, "gps_boot_task", GPS_BOOT_TASK_STACK, NULL, GPS_BOOT_TASK_PRIO, NULL);
 
     printf("Initializing WiFi driver...\n");
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
     ESP_ERROR_CHECK(esp_wifi_start());
+#if HT40_CAPTURE
+    wifi_bandwidths_t bandwidths = { .ghz_2g = WIFI_BW_HT40, .ghz_5g = WIFI_BW_HT40 };
+    if (esp_wifi_set_bandwidths(WIFI_IF_STA, &bandwidths) != ESP_OK) {
+        ESP_LOGW(TAG, "HT40 not available, sniffing at 20 MHz only");
+    }
+#endif
+    boot_mark(BOOT_WIFI);
+
+    ESP_ERROR_CHECK(ap_table_init(MAX_APS));
+    ESP_ERROR_CHECK(arena_init(&cycle_arena, CYCLE_ARENA_SIZE) ? ESP_OK : ESP_ERR_NO_MEM);
+    ESP_ERROR_CHECK(bloom_init(&ap_filter, AP_FILTER_BITS, 2) ? ESP_OK : ESP_ERR_NO_MEM);
+    ESP_ERROR_CHECK(phy_stats_init(MAX_APS) ? ESP_OK : ESP_ERR_NO_MEM);
+#if FILTER_CLIENT_PAIRS
+    ESP_ERROR_CHECK(bloom_init(&pair_filter, PAIR_FILTER_BITS, 3) ? ESP_OK : ESP_ERR_NO_MEM);
+#endif
+    ESP_ERROR_CHECK(scan_snapshot_init(MAX_APS));
 
     printf("Starting WiFi scan task...\n");
     xTaskCreate(wifi_scan_task, "wifi_scan_task", 8192, NULL, 5, NULL);
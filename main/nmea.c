@@ -0,0 +1,212 @@
+#include <string.h>
+
+#include "nmea.h"
+
+enum {
+    NMEA_WAIT_START,
+    NMEA_BODY,
+    NMEA_CHECKSUM_HI,
+    NMEA_CHECKSUM_LO,
+};
+
+#define TYPE_KEY(a, b, c) (((uint32_t)(a) << 16) | ((uint32_t)(b) << 8) | (uint32_t)(c))
+
+static int hex_value(uint8_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+/* Address field: two-letter talker (GP, GN, GL, ...) then the type. */
+static uint8_t sentence_type(const char *addr, int len) {
+    if (len >= 1 && addr[0] == 'P') return NMEA_TYPE_PROPRIETARY;
+    if (len != 5) return NMEA_TYPE_UNKNOWN;
+    switch (TYPE_KEY(addr[2], addr[3], addr[4])) {
+    case TYPE_KEY('G', 'G', 'A'): return NMEA_TYPE_GGA;
+    case TYPE_KEY('R', 'M', 'C'): return NMEA_TYPE_RMC;
+    case TYPE_KEY('G', 'S', 'A'): return NMEA_TYPE_GSA;
+    case TYPE_KEY('G', 'S', 'V'): return NMEA_TYPE_GSV;
+    case TYPE_KEY('V', 'T', 'G'): return NMEA_TYPE_VTG;
+    default: return NMEA_TYPE_UNKNOWN;
+    }
+}
+
+static void close_field(nmea_reader_t *rd) {
+    nmea_fields_t *f = &rd->fields;
+    if (f->count < NMEA_MAX_FIELDS) {
+        f->len[f->count] = rd->len - f->start[f->count];
+        if (f->count == 0) f->type = sentence_type(rd->buf, f->len[0]);
+        f->count++;
+    }
+}
+
+void nmea_reader_init(nmea_reader_t *rd) {
+    memset(rd, 0, sizeof(*rd));
+    rd->fields.base = rd->buf;
+}
+
+void nmea_reader_reset(nmea_reader_t *rd) {
+    rd->state = NMEA_WAIT_START;
+    rd->len = 0;
+}
+
+void nmea_feed(nmea_reader_t *rd, const uint8_t *data, size_t len, nmea_sentence_cb_t cb, void *ctx) {
+    for (size_t i = 0; i < len; i++) {
+        uint8_t c = data[i];
+
+        /* A '$' always starts over, whatever was in progress. */
+        if (c == '$') {
+            if (rd->state != NMEA_WAIT_START) rd->checksum_errors++;
+            rd->state = NMEA_BODY;
+            rd->len = 0;
+            rd->checksum = 0;
+            rd->fields.count = 0;
+            rd->fields.start[0] = 0;
+            rd->fields.type = NMEA_TYPE_UNKNOWN;
+            continue;
+        }
+
+        switch (rd->state) {
+        case NMEA_WAIT_START:
+            break;
+
+        case NMEA_BODY:
+            if (c == '*') {
+                close_field(rd);
+                rd->state = NMEA_CHECKSUM_HI;
+            } else if (c < 0x20 || c > 0x7E) {
+                /* Line end before '*', or noise (e.g. a baud mismatch) the XOR might not catch. */
+                rd->checksum_errors++;
+                rd->state = NMEA_WAIT_START;
+            } else if (rd->len >= NMEA_MAX_LEN - 1) {
+                rd->overruns++;
+                rd->state = NMEA_WAIT_START;
+            } else {
+                rd->checksum ^= c;
+                if (c == ',') {
+                    close_field(rd);
+                    if (rd->fields.count < NMEA_MAX_FIELDS) rd->fields.start[rd->fields.count] = rd->len + 1;
+                }
+                rd->buf[rd->len++] = c;
+            }
+            break;
+
+        case NMEA_CHECKSUM_HI:
+        case NMEA_CHECKSUM_LO: {
+            int v = hex_value(c);
+            if (v < 0) {
+                rd->checksum_errors++;
+                rd->state = NMEA_WAIT_START;
+                break;
+            }
+            if (rd->state == NMEA_CHECKSUM_HI) {
+                rd->expected = v << 4;
+                rd->state = NMEA_CHECKSUM_LO;
+                break;
+            }
+            rd->state = NMEA_WAIT_START;
+            if ((rd->expected | v) != rd->checksum) {
+                rd->checksum_errors++;
+                break;
+            }
+            rd->buf[rd->len] = '\0';
+            rd->sentences++;
+            cb(ctx, &rd->fields);
+            break;
+        }
+        }
+    }
+}
+
+bool nmea_parse_coord(const char *p, int len, char hemisphere, int32_t *out_e7) {
+    int64_t whole = 0;
+    int i = 0;
+    for (; i < len && p[i] != '.'; i++) {
+        if (p[i] < '0' || p[i] > '9' || i >= 5) return false;
+        whole = whole * 10 + (p[i] - '0');
+    }
+    if (i < 3) return false;
+
+    int64_t frac = 0, scale = 1;
+    for (i++; i < len; i++) {
+        if (p[i] < '0' || p[i] > '9') return false;
+        if (scale < 1000000000) {
+            frac = frac * 10 + (p[i] - '0');
+            scale *= 10;
+        }
+    }
+
+    int64_t degrees = whole / 100;
+    int64_t minutes = (whole % 100) * scale + frac;     /* minutes x scale */
+    if (whole % 100 >= 60) return false;
+    int64_t e7 = degrees * 10000000 + (minutes * 10000000 + 30 * scale) / (60 * scale);
+    if (e7 > 1800000000) return false;
+
+    switch (hemisphere) {
+    case 'N': case 'E': break;
+    case 'S': case 'W': e7 = -e7; break;
+    default: return false;
+    }
+    *out_e7 = (int32_t)e7;
+    return true;
+}
+
+/* Days since 1970-01-01 in the proleptic Gregorian calendar (H. Hinnant). */
+static int64_t days_from_civil(int y, int m, int d) {
+    y -= m <= 2;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return (int64_t)era * 146097 + doe - 719468;
+}
+
+bool nmea_parse_utc(const char *time_str, int time_len, const char *date_str, int date_len,
+                    int64_t *out_us) {
+    if (time_len < 6 || date_len != 6) return false;
+    int hh = nmea_parse_digits(time_str, 2);
+    int mm = nmea_parse_digits(time_str + 2, 2);
+    int ss = nmea_parse_digits(time_str + 4, 2);
+    int day = nmea_parse_digits(date_str, 2);
+    int month = nmea_parse_digits(date_str + 2, 2);
+    int year = nmea_parse_digits(date_str + 4, 2);
+    if (hh < 0 || hh > 23 || mm < 0 || mm > 59 || ss < 0 || ss > 60 ||
+        day < 1 || day > 31 || month < 1 || month > 12 || year < 0) {
+        return false;
+    }
+
+    int32_t us = 0;
+    if (time_len > 6) {
+        if (time_str[6] != '.') return false;
+        int32_t scale = 100000;
+        for (int i = 7; i < time_len; i++, scale /= 10) {
+            if (time_str[i] < '0' || time_str[i] > '9') return false;
+            us += (time_str[i] - '0') * scale;
+        }
+    }
+
+    int64_t secs = days_from_civil(2000 + year, month, day) * 86400 + hh * 3600 + mm * 60 + ss;
+    *out_us = secs * 1000000 + us;
+    return true;
+}
+
+bool nmea_rmc_utc(const nmea_fields_t *f, int64_t *out_us) {
+    int status_len, time_len, date_len;
+    const char *status = nmea_field(f, 2, &status_len);
+    const char *time_str = nmea_field(f, 1, &time_len);
+    const char *date_str = nmea_field(f, 9, &date_len);
+    if (status_len != 1 || status[0] != 'A') return false;
+    if (!nmea_parse_utc(time_str, time_len, date_str, date_len, out_us)) return false;
+    int year = 2000 + nmea_parse_digits(date_str + 4, 2);
+    return year >= NMEA_RMC_MIN_YEAR && year <= NMEA_RMC_MAX_YEAR;
+}
+
+int nmea_parse_digits(const char *p, int digits) {
+    int v = 0;
+    for (int i = 0; i < digits; i++) {
+        if (p[i] < '0' || p[i] > '9') return -1;
+        v = v * 10 + (p[i] - '0');
+    }
+    return v;
+}
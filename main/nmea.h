@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Streaming NMEA 0183 framer and tokenizer. Bytes are fed in whatever
+ * chunks the UART delivers; the reader resumes mid-sentence across calls,
+ * XORs the body and records field offsets as bytes arrive, and hands each
+ * complete sentence whose *hh checksum matches to the callback. Nothing is
+ * copied or re-scanned: fields are (offset, length) pairs into the reader's
+ * buffer, empty fields keep their index, and the sentence type is decoded
+ * once from the address field. Sentences longer than NMEA_MAX_LEN, or with
+ * a byte outside printable ASCII before the '*', are dropped and the reader
+ * resynchronises on the next '$'.
+ *
+ * The fields passed to the callback are only valid until it returns.
+ */
+#define NMEA_MAX_LEN 128
+#define NMEA_MAX_FIELDS 24          /* later fields are ignored */
+
+typedef enum {
+    NMEA_TYPE_UNKNOWN,
+    NMEA_TYPE_GGA,
+    NMEA_TYPE_RMC,
+    NMEA_TYPE_GSA,
+    NMEA_TYPE_GSV,
+    NMEA_TYPE_VTG,
+    NMEA_TYPE_PROPRIETARY,          /* $P..., e.g. PMTK replies */
+} nmea_type_t;
+
+typedef struct {
+    const char *base;           /* sentence body, NUL-terminated */
+    uint8_t type;               /* nmea_type_t */
+    uint8_t count;
+    uint8_t start[NMEA_MAX_FIELDS];
+    uint8_t len[NMEA_MAX_FIELDS];
+} nmea_fields_t;
+
+typedef void (*nmea_sentence_cb_t)(void *ctx, const nmea_fields_t *fields);
+
+typedef struct {
+    char buf[NMEA_MAX_LEN];
+    uint16_t len;
+    uint8_t state;
+    uint8_t checksum;           /* running XOR of the body */
+    uint8_t expected;
+    nmea_fields_t fields;
+
+    uint32_t sentences;         /* delivered */
+    uint32_t checksum_errors;   /* mismatched or missing *hh */
+    uint32_t overruns;          /* longer than NMEA_MAX_LEN */
+} nmea_reader_t;
+
+void nmea_reader_init(nmea_reader_t *rd);
+/* Drops any partial sentence, e.g. after the UART lost bytes. */
+void nmea_reader_reset(nmea_reader_t *rd);
+void nmea_feed(nmea_reader_t *rd, const uint8_t *data, size_t len, nmea_sentence_cb_t cb, void *ctx);
+
+/* Field i, or NULL past the end; *len is 0 for an empty field. */
+static inline const char *nmea_field(const nmea_fields_t *f, int i, int *len) {
+    if (i >= f->count) {
+        *len = 0;
+        return NULL;
+    }
+    *len = f->len[i];
+    return f->base + f->start[i];
+}
+
+/* Parses `digits` decimal digits at p; -1 if any is not a digit. */
+int nmea_parse_digits(const char *p, int digits);
+
+/*
+ * Converts a ddmm.mmmm / dddmm.mmmm field and its N/S/E/W hemisphere to
+ * 1e-7 degrees, rounded to nearest (ties away from zero), in integer
+ * arithmetic only. Up to 9 fractional minute digits are used.
+ */
+bool nmea_parse_coord(const char *p, int len, char hemisphere, int32_t *out_e7);
+
+/*
+ * Converts RMC hhmmss[.sss] and ddmmyy fields to microseconds since the
+ * Unix epoch (UTC, years 2000-2099) with a constant-time days-from-civil
+ * calculation; no struct tm, mktime or TZ involved.
+ */
+bool nmea_parse_utc(const char *time_str, int time_len, const char *date_str, int date_len,
+                    int64_t *out_us);
+
+#define NMEA_RMC_MIN_YEAR 2024      /* older dates come from a stale module RTC */
+#define NMEA_RMC_MAX_YEAR 2079      /* 060180 (the GPS epoch, read as 2080) is a module's no-time default */
+
+/*
+ * UTC of an RMC sentence, only when its status (field 2) is 'A' and its
+ * year lies within NMEA_RMC_MIN_YEAR..NMEA_RMC_MAX_YEAR. A void ('V') RMC
+ * still carries time and date fields, often the module's power-on default.
+ */
+bool nmea_rmc_utc(const nmea_fields_t *f, int64_t *out_us);
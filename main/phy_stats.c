@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "phy_stats.h"
+
+typedef struct {
+    mac_key_t bssid;            /* 0 = slot unused since reset */
+    uint32_t frames;
+    phy_hist_t hist;
+    uint8_t nf[PHY_NF_BINS];
+} phy_ap_t;
+
+typedef struct {
+    mac_key_t client;
+    mac_key_t bssid;
+    uint32_t last_seen_ms;
+    uint32_t frames;
+    phy_hist_t hist;
+} phy_client_t;
+
+typedef struct {
+    uint32_t clients;
+    uint32_t table_full;
+} phy_stats_summary_t;
+
+static phy_ap_t *phy_aps = NULL;
+static int phy_ap_capacity = 0;
+static phy_client_t phy_clients[PHY_MAX_CLIENTS];
+static phy_stats_summary_t phy_summary;
+
+static const char *const format_names[PHY_FMT_COUNT] = { "legacy", "HT", "VHT", "HE" };
+static const char *const bw_names[PHY_BW_COUNT] = { "20", "40", "80", "160" };
+
+bool phy_stats_init(int max_aps) {
+    phy_aps = calloc(max_aps, sizeof(phy_ap_t));
+    phy_ap_capacity = phy_aps ? max_aps : 0;
+    return phy_aps != NULL;
+}
+
+static inline void bump(uint8_t *bins, int n, int i) {
+    if (bins[i] == UINT8_MAX) {
+        for (int j = 0; j < n; j++) bins[j] >>= 1;
+    }
+    bins[i]++;
+}
+
+static void hist_add(phy_hist_t *h, const phy_sample_t *s) {
+    bump(h->format, PHY_FMT_COUNT, s->format);
+    bump(h->bw, PHY_BW_COUNT, s->bw);
+    if (s->mcs < PHY_MCS_BINS) bump(h->mcs, PHY_MCS_BINS, s->mcs);
+}
+
+static phy_client_t *client_entry(mac_key_t client, uint32_t now_ms) {
+    uint32_t idx = (mac_key_hash(client) >> 24) & (PHY_MAX_CLIENTS - 1);
+    phy_client_t *oldest = NULL;
+
+    for (int probe = 0; probe < PHY_CLIENT_PROBES; probe++) {
+        phy_client_t *e = &phy_clients[(idx + probe) & (PHY_MAX_CLIENTS - 1)];
+        if (e->client == MAC_KEY_NONE) {
+            phy_summary.clients++;
+            memset(e, 0, sizeof(*e));
+            e->client = client;
+            return e;
+        }
+        if (mac_key_eq(e->client, client)) return e;
+        if (!oldest || now_ms - e->last_seen_ms > now_ms - oldest->last_seen_ms) oldest = e;
+    }
+
+    /* Probe window full: evict the longest-idle client in it. */
+    phy_summary.table_full++;
+    memset(oldest, 0, sizeof(*oldest));
+    oldest->client = client;
+    return oldest;
+}
+
+void phy_stats_observe(int slot, mac_key_t bssid, mac_key_t client, const phy_sample_t *s, uint32_t now_ms) {
+    if (slot >= 0 && slot < phy_ap_capacity) {
+        phy_ap_t *ap = &phy_aps[slot];
+        if (!mac_key_eq(ap->bssid, bssid)) {
+            memset(ap, 0, sizeof(*ap));
+            ap->bssid = bssid;
+        }
+        ap->frames++;
+        hist_add(&ap->hist, s);
+        int nf = (s->noise_floor + 100) / 4;
+        if (nf < 0) nf = 0;
+        if (nf >= PHY_NF_BINS) nf = PHY_NF_BINS - 1;
+        bump(ap->nf, PHY_NF_BINS, nf);
+    }
+
+    phy_client_t *c = client_entry(client, now_ms);
+    c->bssid = bssid;
+    c->last_seen_ms = now_ms;
+    c->frames++;
+    hist_add(&c->hist, s);
+}
+
+static unsigned share(const uint8_t *bins, int n, int i) {
+    unsigned total = 0;
+    for (int j = 0; j < n; j++) total += bins[j];
+    return total ? 100u * bins[i] / total : 0;
+}
+
+static int top_bin(const uint8_t *bins, int n) {
+    int best = -1;
+    for (int j = 0; j < n; j++) {
+        if (bins[j] && (best < 0 || bins[j] > bins[best])) best = j;
+    }
+    return best;
+}
+
+static void print_hist(const phy_hist_t *h) {
+    for (int f = 0; f < PHY_FMT_COUNT; f++) {
+        printf(" %s %3u%%", format_names[f], share(h->format, PHY_FMT_COUNT, f));
+    }
+    printf(" |");
+    for (int b = 0; b < PHY_BW_COUNT - 1; b++) {
+        printf(" %sM %3u%%", bw_names[b], share(h->bw, PHY_BW_COUNT, b));
+    }
+    int mcs = top_bin(h->mcs, PHY_MCS_BINS);
+    if (mcs >= 0) printf(" | MCS%d", mcs);
+    else printf(" | MCS -");
+}
+
+void phy_stats_print_report(void) {
+    printf("PHY per AP (format | width | most common MCS | noise floor):\n");
+    for (int slot = 0; slot < phy_ap_capacity; slot++) {
+        const phy_ap_t *ap = &phy_aps[slot];
+        if (!ap->frames) continue;
+        printf("  " MAC_KEY_FMT " %6u fr:", MAC_KEY_ARGS(ap->bssid), (unsigned)ap->frames);
+        print_hist(&ap->hist);
+        int nf = top_bin(ap->nf, PHY_NF_BINS);
+        printf(" | NF %d dBm\n", nf >= 0 ? -100 + nf * 4 : 0);
+    }
+
+    int legacy = 0;
+    for (int i = 0; i < PHY_MAX_CLIENTS; i++) {
+        const phy_client_t *c = &phy_clients[i];
+        if (c->client == MAC_KEY_NONE) continue;
+        if (share(c->hist.format, PHY_FMT_COUNT, PHY_FMT_LEGACY) < PHY_LEGACY_CLIENT_PCT) continue;
+        if (!legacy++) printf("Legacy-rate clients (>= %d%% legacy frames):\n", PHY_LEGACY_CLIENT_PCT);
+        printf("  " MAC_KEY_FMT " on " MAC_KEY_FMT " %6u fr:",
+               MAC_KEY_ARGS(c->client), MAC_KEY_ARGS(c->bssid), (unsigned)c->frames);
+        print_hist(&c->hist);
+        printf("\n");
+    }
+    printf("PHY stats: %u clients tracked, %u evictions, %d legacy-rate clients\n",
+           (unsigned)phy_summary.clients, (unsigned)phy_summary.table_full, legacy);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mac_key.h"
+
+/*
+ * Per-AP and per-client PHY histograms built from the promiscuous rx_ctrl
+ * header: frame format (legacy/HT/VHT/HE), MCS, channel width and, per AP,
+ * noise floor. Bins are 8-bit; when one would overflow, every bin of that
+ * histogram is halved, so the shares stay right and older frames fade out.
+ *
+ * AP histograms are indexed by ap_table slot and reset when the slot's
+ * BSSID changes. Clients live in an open-addressed table keyed by MAC and
+ * count frames in both directions of their link with the AP, i.e. the
+ * station addressed by FromDS frames and the sender of ToDS frames.
+ * phy_stats_observe() is O(1) and called only from the sniffer callback.
+ */
+#define PHY_MAX_CLIENTS 256         /* power of two */
+#define PHY_CLIENT_PROBES 8
+#define PHY_MCS_BINS 12             /* MCS 0-11, per spatial stream */
+#define PHY_NF_BINS 8               /* 4 dB bins from -100 dBm */
+#define PHY_MCS_NONE 0xFF           /* legacy rates, or MCS not in the header */
+#define PHY_LEGACY_CLIENT_PCT 50    /* report clients with at least this legacy share */
+
+typedef enum {
+    PHY_FMT_LEGACY,
+    PHY_FMT_HT,
+    PHY_FMT_VHT,
+    PHY_FMT_HE,
+    PHY_FMT_COUNT
+} phy_format_t;
+
+typedef enum {
+    PHY_BW_20,
+    PHY_BW_40,
+    PHY_BW_80,
+    PHY_BW_160,
+    PHY_BW_COUNT
+} phy_bw_t;
+
+typedef struct {
+    uint8_t format;             /* phy_format_t */
+    uint8_t mcs;                /* 0-11 or PHY_MCS_NONE */
+    uint8_t bw;                 /* phy_bw_t */
+    int8_t noise_floor;
+} phy_sample_t;
+
+typedef struct {
+    uint8_t format[PHY_FMT_COUNT];
+    uint8_t mcs[PHY_MCS_BINS];
+    uint8_t bw[PHY_BW_COUNT];
+} phy_hist_t;
+
+bool phy_stats_init(int max_aps);
+void phy_stats_observe(int slot, mac_key_t bssid, mac_key_t client, const phy_sample_t *s, uint32_t now_ms);
+void phy_stats_print_report(void);
@@ -0,0 +1,103 @@
+#include <string.h>
+#include <stdatomic.h>
+
+#include "roam.h"
+
+typedef struct {
+    mac_key_t client;
+    mac_key_t bssid;
+    uint32_t ess_id;
+    uint32_t last_seen_ms;
+    int8_t rssi;
+    bool used;
+} roam_client_t;
+
+static roam_client_t roam_clients[ROAM_MAX_CLIENTS];
+static roam_event_t roam_events[ROAM_EVENT_RING];
+static atomic_uint roam_head = 0;   /* written by the producer */
+static atomic_uint roam_tail = 0;   /* written by the consumer */
+static roam_stats_t roam_stats;
+
+uint32_t roam_ess_id(const char *ssid, uint8_t authmode) {
+    if (!ssid[0]) return 0;
+    uint32_t h = 2166136261u;
+    for (const char *p = ssid; *p; p++) {
+        h = (h ^ (uint8_t)*p) * 16777619u;
+    }
+    h = (h ^ authmode) * 16777619u;
+    return h ? h : 1;
+}
+
+static void push_event(const roam_event_t *ev) {
+    unsigned head = atomic_load_explicit(&roam_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&roam_tail, memory_order_acquire);
+    if (head - tail >= ROAM_EVENT_RING) {
+        roam_stats.events_dropped++;
+        return;
+    }
+    roam_events[head & (ROAM_EVENT_RING - 1)] = *ev;
+    atomic_store_explicit(&roam_head, head + 1, memory_order_release);
+}
+
+void roam_observe(mac_key_t client, mac_key_t bssid, uint32_t ess_id, int8_t rssi, uint32_t now_ms) {
+    uint32_t idx = (mac_key_hash(client) >> 24) & (ROAM_MAX_CLIENTS - 1);
+    roam_client_t *oldest = NULL;
+    roam_client_t *c = NULL;
+
+    for (int probe = 0; probe < ROAM_CLIENT_PROBES; probe++) {
+        roam_client_t *e = &roam_clients[(idx + probe) & (ROAM_MAX_CLIENTS - 1)];
+        if (!e->used) {
+            roam_stats.tracked++;
+            oldest = e;
+            break;
+        }
+        if (mac_key_eq(e->client, client)) {
+            c = e;
+            break;
+        }
+        if (!oldest || now_ms - e->last_seen_ms > now_ms - oldest->last_seen_ms) oldest = e;
+    }
+
+    if (!c) {
+        /* New client; a full probe window gives up its longest-idle entry. */
+        if (oldest->used) roam_stats.evicted++;
+        oldest->client = client;
+        oldest->bssid = bssid;
+        oldest->ess_id = ess_id;
+        oldest->last_seen_ms = now_ms;
+        oldest->rssi = rssi;
+        oldest->used = true;
+        return;
+    }
+
+    if (!mac_key_eq(c->bssid, bssid)) {
+        if (ess_id != 0 && ess_id == c->ess_id) {
+            roam_event_t ev;
+            ev.client = client;
+            ev.from = c->bssid;
+            ev.to = bssid;
+            ev.rssi_before = c->rssi;
+            ev.rssi_after = rssi;
+            ev.delta_ms = now_ms - c->last_seen_ms;
+            roam_stats.roams++;
+            push_event(&ev);
+        }
+        c->bssid = bssid;
+        c->ess_id = ess_id;
+    }
+    c->last_seen_ms = now_ms;
+    c->rssi = rssi;
+}
+
+bool roam_pop_event(roam_event_t *out) {
+    unsigned tail = atomic_load_explicit(&roam_tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&roam_head, memory_order_acquire);
+    if (tail == head) return false;
+    *out = roam_events[tail & (ROAM_EVENT_RING - 1)];
+    atomic_store_explicit(&roam_tail, tail + 1, memory_order_release);
+    return true;
+}
+
+void roam_get_stats(roam_stats_t *out) {
+    *out = roam_stats;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mac_key.h"
+
+/*
+ * Client roaming detector. Tracks each client's current BSSID in an
+ * open-addressed table keyed by client MAC. Lookups stay within
+ * ROAM_CLIENT_PROBES slots of the home bucket, so a frame from an untracked
+ * client costs a bounded probe even when the table is full; the
+ * longest-idle client in the window makes room. When a client shows up on
+ * another BSSID of the same ESS (same SSID and security, see roam_ess_id) a
+ * roam event is queued.
+ *
+ * roam_observe() is called from the sniffer callback and is the only
+ * producer; one consumer task drains events with roam_pop_event().
+ */
+#define ROAM_MAX_CLIENTS 256        /* power of two */
+#define ROAM_EVENT_RING 32          /* power of two */
+#define ROAM_CLIENT_PROBES 8
+
+typedef struct {
+    mac_key_t client;
+    mac_key_t from;
+    mac_key_t to;
+    int8_t rssi_before;
+    int8_t rssi_after;
+    uint32_t delta_ms;          /* last frame on `from` to first frame on `to` */
+} roam_event_t;
+
+typedef struct {
+    uint32_t tracked;
+    uint32_t roams;
+    uint32_t events_dropped;
+    uint32_t evicted;
+} roam_stats_t;
+
+/* ESS key for an AP; 0 means "no ESS" (hidden SSID) and never roams. */
+uint32_t roam_ess_id(const char *ssid, uint8_t authmode);
+
+void roam_observe(mac_key_t client, mac_key_t bssid, uint32_t ess_id, int8_t rssi, uint32_t now_ms);
+bool roam_pop_event(roam_event_t *out);
+void roam_get_stats(roam_stats_t *out);
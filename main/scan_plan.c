@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <string.h>
+#include "esp_wifi.h"
+#include "esp_timer.h"
+
+#include "scan_plan.h"
+
+#define DFS_EVERY_N_CYCLES 4
+
+/*
+ * Default plan for the C5: every 2.4 GHz channel and the non-DFS 5 GHz
+ * channels are probed actively each cycle; DFS channels (52-144) may not be
+ * probed, so they are listened to passively and only every few cycles.
+ */
+static const scan_plan_entry_t default_entries[] = {
+    { 1, false, 120, 1 }, { 2, false, 120, 1 }, { 3, false, 120, 1 }, { 4, false, 120, 1 },
+    { 5, false, 120, 1 }, { 6, false, 120, 1 }, { 7, false, 120, 1 }, { 8, false, 120, 1 },
+    { 9, false, 120, 1 }, { 10, false, 120, 1 }, { 11, false, 120, 1 }, { 12, false, 120, 1 },
+    { 13, false, 120, 1 },
+
+    { 36, false, 100, 1 }, { 40, false, 100, 1 }, { 44, false, 100, 1 }, { 48, false, 100, 1 },
+
+    { 52, true, 110, DFS_EVERY_N_CYCLES }, { 56, true, 110, DFS_EVERY_N_CYCLES },
+    { 60, true, 110, DFS_EVERY_N_CYCLES }, { 64, true, 110, DFS_EVERY_N_CYCLES },
+    { 100, true, 110, DFS_EVERY_N_CYCLES }, { 104, true, 110, DFS_EVERY_N_CYCLES },
+    { 108, true, 110, DFS_EVERY_N_CYCLES }, { 112, true, 110, DFS_EVERY_N_CYCLES },
+    { 116, true, 110, DFS_EVERY_N_CYCLES }, { 120, true, 110, DFS_EVERY_N_CYCLES },
+    { 124, true, 110, DFS_EVERY_N_CYCLES }, { 128, true, 110, DFS_EVERY_N_CYCLES },
+    { 132, true, 110, DFS_EVERY_N_CYCLES }, { 136, true, 110, DFS_EVERY_N_CYCLES },
+    { 140, true, 110, DFS_EVERY_N_CYCLES }, { 144, true, 110, DFS_EVERY_N_CYCLES },
+
+    { 149, false, 100, 1 }, { 153, false, 100, 1 }, { 157, false, 100, 1 }, { 161, false, 100, 1 },
+    { 165, false, 100, 1 },
+};
+
+static const scan_plan_t default_plan = {
+    .name = "default",
+    .entries = default_entries,
+    .entry_count = sizeof(default_entries) / sizeof(default_entries[0])
+};
+
+const scan_plan_t *scan_plan_default(void) {
+    return &default_plan;
+}
+
+void scan_plan_run(const scan_plan_t *plan, uint32_t cycle, const channel_mask_t *only,
+                   scan_plan_collect_t collect, scan_plan_report_t *report, channel_mask_t *scanned) {
+    memset(report, 0, sizeof(*report));
+    report->refresh = (only != NULL);
+    channel_mask_clear(scanned);
+
+    for (int i = 0; i < plan->entry_count; i++) {
+        const scan_plan_entry_t *e = &plan->entries[i];
+        scan_band_t band = scan_band_of(e->channel);
+        bool due = only ? channel_mask_test(only, e->channel)
+                        : (e->every_n_cycles <= 1 || cycle % e->every_n_cycles == 0);
+        if (!due) {
+            report->channels_skipped[band]++;
+            continue;
+        }
+
+        wifi_scan_config_t cfg = {
+            .ssid = NULL,
+            .bssid = NULL,
+            .channel = e->channel,
+            .show_hidden = true,
+            .scan_type = e->passive ? WIFI_SCAN_TYPE_PASSIVE : WIFI_SCAN_TYPE_ACTIVE,
+        };
+        if (e->passive) {
+            cfg.scan_time.passive = e->dwell_ms;
+        } else {
+            cfg.scan_time.active.min = e->dwell_ms / 2;
+            cfg.scan_time.active.max = e->dwell_ms;
+        }
+
+        int64_t start = esp_timer_get_time();
+        if (esp_wifi_scan_start(&cfg, true) == ESP_OK) {
+            collect();
+            channel_mask_set(scanned, e->channel);
+        }
+        report->time_ms[band] += (esp_timer_get_time() - start) / 1000;
+        report->channels[band]++;
+        if (e->passive) report->passive_channels++;
+    }
+}
+
+void scan_plan_print_report(const scan_plan_report_t *report) {
+    printf("Scan (%s): 2.4G %u ch in %u ms, 5G %u ch in %u ms (%u passive, %u skipped)\n",
+           report->refresh ? "refresh" : "full sweep",
+           report->channels[SCAN_BAND_2G], (unsigned)report->time_ms[SCAN_BAND_2G],
+           report->channels[SCAN_BAND_5G], (unsigned)report->time_ms[SCAN_BAND_5G],
+           report->passive_channels,
+           report->channels_skipped[SCAN_BAND_2G] + report->channels_skipped[SCAN_BAND_5G]);
+}
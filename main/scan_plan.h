@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "channel_mask.h"
+
+typedef enum {
+    SCAN_BAND_2G,
+    SCAN_BAND_5G,
+    SCAN_BAND_COUNT
+} scan_band_t;
+
+typedef struct {
+    uint8_t channel;
+    bool passive;
+    uint16_t dwell_ms;          /* active max / passive listen time */
+    uint8_t every_n_cycles;     /* 1 = every cycle */
+} scan_plan_entry_t;
+
+typedef struct {
+    const char *name;
+    const scan_plan_entry_t *entries;
+    int entry_count;
+} scan_plan_t;
+
+typedef struct {
+    uint32_t time_ms[SCAN_BAND_COUNT];
+    uint16_t channels[SCAN_BAND_COUNT];
+    uint16_t channels_skipped[SCAN_BAND_COUNT];
+    uint16_t passive_channels;
+    bool refresh;               /* targeted refresh rather than a full sweep */
+} scan_plan_report_t;
+
+/* Called after each single-channel scan to drain the driver's AP list. */
+typedef void (*scan_plan_collect_t)(void);
+
+static inline scan_band_t scan_band_of(uint8_t channel) {
+    return channel <= 14 ? SCAN_BAND_2G : SCAN_BAND_5G;
+}
+
+const scan_plan_t *scan_plan_default(void);
+
+/*
+ * Runs every entry due on `cycle` as its own single-channel scan and marks
+ * the channels it covered in `scanned`. With `only` set this is a targeted
+ * refresh: just the plan entries for those channels run, whatever their
+ * every_n_cycles, and `cycle` is ignored.
+ */
+void scan_plan_run(const scan_plan_t *plan, uint32_t cycle, const channel_mask_t *only,
+                   scan_plan_collect_t collect, scan_plan_report_t *report, channel_mask_t *scanned);
+
+void scan_plan_print_report(const scan_plan_report_t *report);
@@ -0,0 +1,69 @@
+#include <string.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+#include "scan_snapshot.h"
+
+typedef struct {
+    atomic_uint seq;            /* odd while the writer owns the buffer */
+    scan_snapshot_t snap;
+} snapshot_buf_t;
+
+static snapshot_buf_t snapshot_bufs[2];
+static atomic_int snapshot_front = 0;
+static uint32_t snapshot_version = 0;
+
+esp_err_t scan_snapshot_init(int capacity) {
+    for (int i = 0; i < 2; i++) {
+        snapshot_buf_t *b = &snapshot_bufs[i];
+        b->snap.rows = calloc(capacity, sizeof(scan_result_t));
+        if (!b->snap.rows) return ESP_ERR_NO_MEM;
+        b->snap.capacity = capacity;
+        atomic_init(&b->seq, 0);
+    }
+    return ESP_OK;
+}
+
+scan_snapshot_t *scan_snapshot_begin(void) {
+    snapshot_buf_t *back = &snapshot_bufs[atomic_load(&snapshot_front) ^ 1];
+    atomic_fetch_add_explicit(&back->seq, 1, memory_order_acq_rel);
+    memset(&back->snap.info, 0, sizeof(back->snap.info));
+    return &back->snap;
+}
+
+void scan_snapshot_publish(void) {
+    int back_idx = atomic_load(&snapshot_front) ^ 1;
+    snapshot_buf_t *back = &snapshot_bufs[back_idx];
+    back->snap.info.version = ++snapshot_version;
+    back->snap.info.published_us = esp_timer_get_time();
+    atomic_fetch_add_explicit(&back->seq, 1, memory_order_release);
+    atomic_store_explicit(&snapshot_front, back_idx, memory_order_release);
+}
+
+int scan_snapshot_read(scan_snapshot_info_t *info, scan_result_t *rows, int first, int max_rows) {
+    while (1) {
+        const snapshot_buf_t *b = &snapshot_bufs[atomic_load_explicit(&snapshot_front, memory_order_acquire)];
+        unsigned seq = atomic_load_explicit(&b->seq, memory_order_acquire);
+        if (seq & 1) {
+            /* Writer is refilling this buffer; let it finish. */
+            vTaskDelay(1);
+            continue;
+        }
+
+        *info = b->snap.info;
+        int n = 0;
+        if (rows && first >= 0 && first < info->count) {
+            n = info->count - first;
+            if (n > max_rows) n = max_rows;
+            memcpy(rows, &b->snap.rows[first], n * sizeof(scan_result_t));
+        }
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&b->seq, memory_order_relaxed) == seq) {
+            return n;
+        }
+    }
+}
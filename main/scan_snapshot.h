@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_wifi_types.h"
+
+#include "mac_key.h"
+
+typedef struct {
+    char ssid[33];
+    uint8_t channel;
+    int rssi;
+    mac_key_t bssid;
+    int client_count;
+    wifi_auth_mode_t authmode;
+    uint16_t slot;              /* stable per-BSSID id in the live AP table */
+    bool located;               /* estimated AP position, see ap_locate.h */
+    int32_t lat_e7;             /* 1e-7 degrees */
+    int32_t lon_e7;
+    uint32_t radius_m;
+} scan_result_t;
+
+typedef struct {
+    uint32_t version;           /* 0 until the first publish */
+    int64_t published_us;
+    int count;
+} scan_snapshot_info_t;
+
+typedef struct {
+    scan_snapshot_info_t info;
+    scan_result_t *rows;
+    int capacity;
+} scan_snapshot_t;
+
+/*
+ * Double-buffered, seqlock-protected publication of scan results.
+ *
+ * The scan task is the only writer: it fills the back buffer returned by
+ * scan_snapshot_begin() and swaps it in with scan_snapshot_publish().
+ * Readers copy a consistent view out with scan_snapshot_read() and retry
+ * if the buffer was recycled under them, so the writer never waits.
+ */
+esp_err_t scan_snapshot_init(int capacity);
+scan_snapshot_t *scan_snapshot_begin(void);
+void scan_snapshot_publish(void);
+
+/*
+ * Copies the header and up to max_rows rows starting at `first` from the
+ * latest published snapshot. Returns the number of rows copied.
+ */
+int scan_snapshot_read(scan_snapshot_info_t *info, scan_result_t *rows, int first, int max_rows);
@@ -0,0 +1,111 @@
+#include <string.h>
+#include <stdlib.h>
+
+#include "ssid_pool.h"
+
+typedef struct {
+    uint32_t hash;
+    uint16_t next;              /* bucket chain, or free list when unused */
+    uint16_t refs;
+    uint8_t len;
+    char str[SSID_MAX_LEN + 1];
+} ssid_slot_t;
+
+static ssid_slot_t *slots = NULL;
+static uint16_t *buckets = NULL;
+static int slot_capacity = 0;
+static int bucket_mask = 0;
+static uint16_t free_head = SSID_NONE;
+static int unique_count = 0;
+static int ref_count = 0;
+
+static uint32_t ssid_hash(const char *s, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ (uint8_t)s[i]) * 16777619u;
+    }
+    return h;
+}
+
+bool ssid_pool_init(int capacity) {
+    if (capacity >= SSID_NONE) return false;
+    int nbuckets = 1;
+    while (nbuckets < capacity) nbuckets <<= 1;
+
+    slots = calloc(capacity, sizeof(ssid_slot_t));
+    buckets = malloc(nbuckets * sizeof(uint16_t));
+    if (!slots || !buckets) {
+        free(slots);
+        free(buckets);
+        slots = NULL;
+        buckets = NULL;
+        return false;
+    }
+
+    for (int i = 0; i < nbuckets; i++) buckets[i] = SSID_NONE;
+    for (int i = 0; i < capacity; i++) {
+        slots[i].next = (i + 1 < capacity) ? i + 1 : SSID_NONE;
+    }
+    free_head = 0;
+    slot_capacity = capacity;
+    bucket_mask = nbuckets - 1;
+    return true;
+}
+
+uint16_t ssid_pool_intern(const char *ssid) {
+    size_t len = strnlen(ssid, SSID_MAX_LEN);
+    uint32_t h = ssid_hash(ssid, len);
+    uint16_t *bucket = &buckets[h & bucket_mask];
+
+    for (uint16_t id = *bucket; id != SSID_NONE; id = slots[id].next) {
+        ssid_slot_t *s = &slots[id];
+        if (s->hash == h && s->len == len && memcmp(s->str, ssid, len) == 0) {
+            s->refs++;
+            ref_count++;
+            return id;
+        }
+    }
+
+    if (free_head == SSID_NONE) return SSID_NONE;
+    uint16_t id = free_head;
+    ssid_slot_t *s = &slots[id];
+    free_head = s->next;
+
+    s->hash = h;
+    s->len = len;
+    memcpy(s->str, ssid, len);
+    s->str[len] = '\0';
+    s->refs = 1;
+    s->next = *bucket;
+    *bucket = id;
+    unique_count++;
+    ref_count++;
+    return id;
+}
+
+void ssid_pool_release(uint16_t id) {
+    if (id == SSID_NONE) return;
+    ssid_slot_t *s = &slots[id];
+    ref_count--;
+    if (--s->refs > 0) return;
+
+    uint16_t *link = &buckets[s->hash & bucket_mask];
+    while (*link != id) link = &slots[*link].next;
+    *link = s->next;
+
+    s->next = free_head;
+    free_head = id;
+    unique_count--;
+}
+
+const char *ssid_pool_get(uint16_t id) {
+    return id == SSID_NONE ? "" : slots[id].str;
+}
+
+void ssid_pool_get_stats(ssid_pool_stats_t *out) {
+    out->unique = unique_count;
+    out->refs = ref_count;
+    out->capacity = slot_capacity;
+    out->slot_bytes = sizeof(ssid_slot_t);
+    out->pool_bytes = slot_capacity * sizeof(ssid_slot_t) + (bucket_mask + 1) * sizeof(uint16_t);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Interned SSID strings. Each distinct SSID is stored once in a refcounted
+ * slot and referred to by a 16-bit id, so the BSSIDs of one network (often
+ * a dozen across both bands) share a single copy. Not thread-safe.
+ */
+#define SSID_NONE 0xFFFF
+#define SSID_MAX_LEN 32
+
+typedef struct {
+    int unique;
+    int refs;
+    int capacity;
+    size_t pool_bytes;
+    size_t slot_bytes;
+} ssid_pool_stats_t;
+
+bool ssid_pool_init(int capacity);
+
+/* Returns the id for `ssid` with one more reference, or SSID_NONE if full. */
+uint16_t ssid_pool_intern(const char *ssid);
+void ssid_pool_release(uint16_t id);
+const char *ssid_pool_get(uint16_t id);
+
+void ssid_pool_get_stats(ssid_pool_stats_t *out);
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+
+/* Element sections (after the 12-byte fixed fields) of typical beacons. */
+
+/* 2.4 GHz WPA2-PSK, HT40 above, BSS Load, WMM. */
+static const uint8_t beacon_wpa2_ht40[] = {
+    0x00, 6, 'H', 'o', 'm', 'e', 'A', 'P',
+    0x01, 8, 0x82, 0x84, 0x8B, 0x96, 0x0C, 0x12, 0x18, 0x24,
+    0x03, 1, 6,
+    0x05, 4, 0x00, 0x01, 0x00, 0x00,
+    0x07, 6, 'D', 'E', 0x20, 0x01, 0x0D, 0x14,
+    0x0B, 5, 0x03, 0x00, 0x2A, 0x00, 0x00,
+    0x2D, 26, 0xEF, 0x19, 0x1B, 0xFF, 0xFF, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0x30, 20, 0x01, 0x00, 0x00, 0x0F, 0xAC, 0x04, 0x01, 0x00, 0x00, 0x0F, 0xAC, 0x04,
+              0x01, 0x00, 0x00, 0x0F, 0xAC, 0x02, 0x8C, 0x00,
+    0x3D, 22, 6, 0x05, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0x7F, 8, 0x04, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x40,
+    0xDD, 24, 0x00, 0x50, 0xF2, 0x02, 0x01, 0x01, 0x80, 0x00, 0x03, 0xA4, 0x00, 0x00,
+              0x27, 0xA4, 0x00, 0x00, 0x42, 0x43, 0x5E, 0x00, 0x62, 0x32, 0x2F, 0x00,
+};
+
+/* 5 GHz WPA3-SAE with PMF required, VHT80, HE. */
+static const uint8_t beacon_wpa3_vht80_he[] = {
+    0x00, 9, 'O', 'f', 'f', 'i', 'c', 'e', '-', '5', 'G',
+    0x01, 8, 0x8C, 0x12, 0x98, 0x24, 0xB0, 0x48, 0x60, 0x6C,
+    0x03, 1, 36,
+    0x05, 4, 0x01, 0x03, 0x00, 0x00,
+    0x07, 6, 'U', 'S', 0x20, 0x24, 0x04, 0x17,
+    0x0B, 5, 0x0C, 0x00, 0x51, 0x00, 0x00,
+    0x2D, 26, 0xEF, 0x09, 0x1B, 0xFF, 0xFF, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0x30, 20, 0x01, 0x00, 0x00, 0x0F, 0xAC, 0x04, 0x01, 0x00, 0x00, 0x0F, 0xAC, 0x04,
+              0x01, 0x00, 0x00, 0x0F, 0xAC, 0x08, 0xC0, 0x00,
+    0x3D, 22, 36, 0x05, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0xBF, 12, 0x91, 0x59, 0x82, 0x0F, 0xEA, 0xFF, 0x00, 0x00, 0xEA, 0xFF, 0x00, 0x00,
+    0xC0, 5, 0x01, 42, 0x00, 0xFC, 0xFF,
+    0xFF, 22, 35, 0x05, 0x00, 0x18, 0x12, 0x00, 0x10, 0x20, 0x20, 0x02, 0xC0, 0x0F,
+              0x41, 0x83, 0x80, 0x00, 0xFA, 0xFF, 0xFA, 0xFF, 0x79, 0x1C,
+    0xFF, 7, 36, 0xF4, 0x3F, 0x00, 0x27, 0xFC, 0xFF,
+};
+
+/* Hidden open network: empty SSID, no RSN or HT. */
+static const uint8_t beacon_open_hidden[] = {
+    0x00, 0,
+    0x01, 4, 0x82, 0x84, 0x8B, 0x96,
+    0x03, 1, 11,
+    0x05, 4, 0x00, 0x01, 0x00, 0x00,
+};
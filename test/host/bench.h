@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Timing helpers for the host benchmarks. For meaningful numbers configure
+ * with -DHOST_SANITIZE=OFF -DCMAKE_BUILD_TYPE=Release; under ctest they run
+ * with --smoke, a few iterations only, so they keep building and running.
+ */
+static inline uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/* Keeps results alive so the compiler cannot drop the measured loop. */
+static volatile uint64_t bench_sink;
+
+static inline int bench_iterations(int argc, char **argv, int full) {
+    return (argc > 1 && strcmp(argv[1], "--smoke") == 0) ? 1 : full;
+}
+
+/* xorshift64, deterministic across runs. */
+static inline uint64_t bench_rand(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ap_table.h"
+#include "bench.h"
+
+/*
+ * AP table lookup and sort throughput. Lookups compare the original linear
+ * memcmp scan over ~60-byte scan_result_t entries, a linear scan of the
+ * packed key array, and ap_table_find through the BSSID hash index. The
+ * index is where the per-frame saving comes from: the packed-key scan is
+ * no faster than the memcmp one. The sort compares qsort of whole entries
+ * with ap_table_order, the permutation sort the report uses.
+ */
+#define APS 160
+#define FRAMES 4096
+#define TRACKED_PCT 70
+
+/* The layout before the split. */
+typedef struct {
+    char ssid[33];
+    uint8_t channel;
+    int rssi;
+    uint8_t bssid[6];
+    int client_count;
+    wifi_auth_mode_t authmode;
+} legacy_result_t;
+
+/* ap_table only needs the track to resolve sightings; none here. */
+bool gps_track_get(gps_ref_t ref, gps_point_t *out) {
+    return false;
+}
+
+static legacy_result_t legacy[APS];
+static mac_key_t packed[APS];
+static uint8_t frames[FRAMES][6];
+
+static int legacy_find(const uint8_t *bssid) {
+    for (int i = 0; i < APS; i++) {
+        if (memcmp(legacy[i].bssid, bssid, 6) == 0) return i;
+    }
+    return -1;
+}
+
+static int packed_find(mac_key_t bssid) {
+    for (int i = 0; i < APS; i++) {
+        if (packed[i] == bssid) return i;
+    }
+    return -1;
+}
+
+static int compare_legacy(const void *a, const void *b) {
+    return ((const legacy_result_t *)b)->rssi - ((const legacy_result_t *)a)->rssi;
+}
+
+static void report(const char *name, uint64_t ns, uint64_t ops) {
+    printf("  %-34s %8.1f ns/op %10.2f Mops/s\n", name, (double)ns / ops, ops * 1e3 / (double)ns);
+}
+
+int main(int argc, char **argv) {
+    int rounds = bench_iterations(argc, argv, 2000);
+    uint64_t rng = 0x9E3779B97F4A7C15ull;
+
+    wifi_ap_record_t *records = calloc(APS, sizeof(wifi_ap_record_t));
+    for (int i = 0; i < APS; i++) {
+        uint64_t r = bench_rand(&rng);
+        for (int b = 0; b < 6; b++) records[i].bssid[b] = r >> (8 * b);
+        records[i].bssid[0] &= 0xFE;
+        snprintf((char *)records[i].ssid, sizeof(records[i].ssid), "net-%d", i % 40);
+        records[i].primary = 1 + i % 11;
+        records[i].rssi = -30 - (int)(r >> 56) % 60;
+        records[i].authmode = WIFI_AUTH_WPA2_PSK;
+
+        memcpy(legacy[i].bssid, records[i].bssid, 6);
+        memcpy(legacy[i].ssid, records[i].ssid, 33);
+        legacy[i].channel = records[i].primary;
+        legacy[i].rssi = records[i].rssi;
+        packed[i] = mac_key_from_bytes(records[i].bssid);
+    }
+    if (ap_table_init(APS) != ESP_OK) return EXIT_FAILURE;
+    ap_table_reserve(APS);
+    ap_table_begin_update(false);
+    ap_table_merge(records, APS, GPS_REF_NONE);
+    ap_table_end_update(NULL);
+
+    for (int f = 0; f < FRAMES; f++) {
+        if ((int)(bench_rand(&rng) % 100) < TRACKED_PCT) {
+            memcpy(frames[f], records[bench_rand(&rng) % APS].bssid, 6);
+        } else {
+            uint64_t r = bench_rand(&rng);
+            for (int b = 0; b < 6; b++) frames[f][b] = r >> (8 * b);
+        }
+    }
+
+    printf("AP table, %d APs, %d%% of frames from tracked BSSIDs:\n", APS, TRACKED_PCT);
+    uint64_t ops = (uint64_t)rounds * FRAMES;
+    int found[3] = { 0, 0, 0 };
+
+    uint64_t t0 = bench_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int f = 0; f < FRAMES; f++) found[0] += legacy_find(frames[f]) >= 0;
+    }
+    report("lookup, AoS memcmp scan", bench_now_ns() - t0, ops);
+
+    t0 = bench_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int f = 0; f < FRAMES; f++) found[1] += packed_find(mac_key_from_bytes(frames[f])) >= 0;
+    }
+    report("lookup, packed-key scan", bench_now_ns() - t0, ops);
+
+    t0 = bench_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int f = 0; f < FRAMES; f++) found[2] += ap_table_find(mac_key_from_bytes(frames[f])) >= 0;
+    }
+    report("lookup, ap_table_find (hash index)", bench_now_ns() - t0, ops);
+
+    if (found[0] != found[1] || found[0] != found[2]) {
+        fprintf(stderr, "lookups disagree: %d %d %d\n", found[0], found[1], found[2]);
+        return EXIT_FAILURE;
+    }
+
+    int sort_rounds = rounds * 4;
+    legacy_result_t *scratch = malloc(sizeof(legacy));
+    t0 = bench_now_ns();
+    for (int r = 0; r < sort_rounds; r++) {
+        memcpy(scratch, legacy, sizeof(legacy));
+        qsort(scratch, APS, sizeof(legacy_result_t), compare_legacy);
+        bench_sink += scratch[0].rssi;
+    }
+    report("sort, qsort of AoS entries", bench_now_ns() - t0, sort_rounds);
+
+    ap_order_t order[APS];
+    t0 = bench_now_ns();
+    for (int r = 0; r < sort_rounds; r++) {
+        ap_table_order(order, APS, true);
+        bench_sink += order[0].slot;
+    }
+    report("sort, ap_table_order permutation", bench_now_ns() - t0, sort_rounds);
+
+    free(scratch);
+    free(records);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "beacon_samples.h"
+#include "bench.h"
+#include "ie.h"
+
+/*
+ * Beacon element throughput: the bare header walk every body needs, and
+ * the full ie_parse the sniffer runs on each beacon from a tracked AP.
+ */
+typedef struct {
+    const char *name;
+    const uint8_t *body;
+    size_t len;
+} sample_t;
+
+static const sample_t samples[] = {
+    { "WPA2 HT40", beacon_wpa2_ht40, sizeof(beacon_wpa2_ht40) },
+    { "WPA3 VHT80 HE", beacon_wpa3_vht80_he, sizeof(beacon_wpa3_vht80_he) },
+    { "open hidden", beacon_open_hidden, sizeof(beacon_open_hidden) },
+};
+
+static void report(const char *what, const sample_t *s, uint64_t ns, long ops) {
+    printf("  %-14s %-10s %4zu B %8.1f ns/beacon %8.1f MB/s\n", s->name, what, s->len, (double)ns / ops,
+           (double)s->len * ops * 1e3 / ns);
+}
+
+int main(int argc, char **argv) {
+    long rounds = bench_iterations(argc, argv, 2000000);
+
+    printf("IE parsing:\n");
+    for (size_t i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+        const sample_t *s = &samples[i];
+        ie_info_t info;
+
+        uint64_t t0 = bench_now_ns();
+        for (long r = 0; r < rounds; r++) {
+            ie_iter_t it;
+            ie_t ie;
+            ie_iter_init(&it, s->body, s->len);
+            while (ie_next(&it, &ie)) bench_sink += ie.id;
+        }
+        report("walk", s, bench_now_ns() - t0, rounds);
+
+        t0 = bench_now_ns();
+        for (long r = 0; r < rounds; r++) {
+            ie_parse(s->body, s->len, &info);
+            bench_sink += info.akms;
+        }
+        report("parse", s, bench_now_ns() - t0, rounds);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "mac_key.h"
+
+/*
+ * MAC handling costs: 6-byte memcmp/memcpy against packed-key compares, the
+ * client-list membership test the sniffer runs per frame, and mac_key_hash
+ * against a byte-wise FNV-1a on addresses that share an OUI, as real ones
+ * near a vendor's APs do. Bucket spread is reported for the high bits
+ * (what the indexes use) and, for contrast, the low bits.
+ */
+#define MACS 4096
+#define LIST_LEN 10         /* MAX_CLIENTS */
+#define BUCKET_BITS 8
+
+static uint8_t macs[MACS][6];
+static mac_key_t keys[MACS];
+
+static uint32_t fnv1a_mac(const uint8_t *mac) {
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < 6; i++) h = (h ^ mac[i]) * 16777619u;
+    return h;
+}
+
+static void report(const char *name, uint64_t ns, uint64_t ops) {
+    printf("  %-36s %8.2f ns/op\n", name, (double)ns / ops);
+}
+
+static int max_bucket(const uint32_t *hashes, int shift, uint32_t mask) {
+    int counts[1 << BUCKET_BITS] = { 0 };
+    int worst = 0;
+    for (int i = 0; i < MACS; i++) {
+        int b = (hashes[i] >> shift) & mask;
+        if (++counts[b] > worst) worst = counts[b];
+    }
+    return worst;
+}
+
+int main(int argc, char **argv) {
+    int rounds = bench_iterations(argc, argv, 4000);
+    uint64_t rng = 0xD1B54A32D192ED03ull;
+
+    /* Three OUIs, sequential-ish NIC parts. */
+    static const uint8_t ouis[3][3] = { { 0x3C, 0x84, 0x6A }, { 0xA4, 0x2B, 0xB0 }, { 0x02, 0x1A, 0x11 } };
+    for (int i = 0; i < MACS; i++) {
+        memcpy(macs[i], ouis[i % 3], 3);
+        uint32_t nic = (uint32_t)(i * 4 + (bench_rand(&rng) & 3));
+        macs[i][3] = nic >> 16;
+        macs[i][4] = nic >> 8;
+        macs[i][5] = nic;
+        keys[i] = mac_key_from_bytes(macs[i]);
+
+        uint8_t back[6];
+        mac_key_to_bytes(keys[i], back);
+        if (memcmp(back, macs[i], 6) != 0) {
+            fprintf(stderr, "round trip failed at %d\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("MAC keys, %d addresses:\n", MACS);
+    uint64_t ops = (uint64_t)rounds * MACS;
+    uint64_t hits = 0, t0;
+
+    t0 = bench_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < MACS; i++) hits += memcmp(macs[i], macs[(i + r) & (MACS - 1)], 6) == 0;
+    }
+    report("compare, memcmp 6 bytes", bench_now_ns() - t0, ops);
+
+    t0 = bench_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < MACS; i++) hits += mac_key_eq(keys[i], keys[(i + r) & (MACS - 1)]);
+    }
+    report("compare, mac_key_eq", bench_now_ns() - t0, ops);
+
+    uint8_t copy[6];
+    t0 = bench_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < MACS; i++) {
+            memcpy(copy, macs[(i + r) & (MACS - 1)], 6);
+            hits += copy[5];
+        }
+    }
+    report("ingest, memcpy 6 bytes", bench_now_ns() - t0, ops);
+
+    t0 = bench_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < MACS; i++) hits += mac_key_from_bytes(macs[(i + r) & (MACS - 1)]) >> 40;
+    }
+    report("ingest, mac_key_from_bytes", bench_now_ns() - t0, ops);
+
+    /* Membership in a full client list, the per-frame check before an insert. */
+    uint64_t list_hits[2] = { 0, 0 };
+    t0 = bench_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < MACS; i++) {
+            const uint8_t *mac = macs[(i * 7 + r) & (MACS - 1)];
+            for (int j = 0; j < LIST_LEN; j++) {
+                if (memcmp(macs[j], mac, 6) == 0) {
+                    list_hits[0]++;
+                    break;
+                }
+            }
+        }
+    }
+    report("client list, memcmp scan", bench_now_ns() - t0, ops);
+
+    t0 = bench_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < MACS; i++) {
+            mac_key_t key = keys[(i * 7 + r) & (MACS - 1)];
+            for (int j = 0; j < LIST_LEN; j++) {
+                if (keys[j] == key) {
+                    list_hits[1]++;
+                    break;
+                }
+            }
+        }
+    }
+    report("client list, key scan", bench_now_ns() - t0, ops);
+
+    t0 = bench_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < MACS; i++) hits += fnv1a_mac(macs[i]) >> 24;
+    }
+    report("hash, FNV-1a over bytes", bench_now_ns() - t0, ops);
+
+    t0 = bench_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < MACS; i++) hits += mac_key_hash(keys[i]) >> 24;
+    }
+    report("hash, mac_key_hash", bench_now_ns() - t0, ops);
+    bench_sink += hits;
+
+    if (list_hits[0] != list_hits[1]) {
+        fprintf(stderr, "list scans disagree: %llu %llu\n", (unsigned long long)list_hits[0],
+                (unsigned long long)list_hits[1]);
+        return EXIT_FAILURE;
+    }
+
+    static uint32_t fnv[MACS], packed[MACS];
+    for (int i = 0; i < MACS; i++) {
+        fnv[i] = fnv1a_mac(macs[i]);
+        packed[i] = mac_key_hash(keys[i]);
+    }
+    uint32_t mask = (1u << BUCKET_BITS) - 1;
+    int ideal = MACS >> BUCKET_BITS;
+    int high = max_bucket(packed, 32 - BUCKET_BITS, mask);
+    printf("  fullest of %d buckets (ideal %d): FNV-1a %d, mac_key_hash high bits %d, low bits %d\n",
+           1 << BUCKET_BITS, ideal, max_bucket(fnv, 32 - BUCKET_BITS, mask), high, max_bucket(packed, 0, mask));
+
+    /* The indexes take the high bits; they must spread real address blocks. */
+    if (high > ideal * 3) {
+        fprintf(stderr, "mac_key_hash clusters: %d in one bucket\n", high);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "nmea.h"
+#include "nmea_samples.h"
+
+/*
+ * GPS input path throughput on a default-output stream (GGA, GSA, GSV,
+ * RMC per fix): nmea_feed framing, checksumming and tokenizing in one
+ * pass, against the same framing followed by the copy + strtok_r + strstr
+ * dispatch the GPS task used before; then the field parsers on their own.
+ */
+#define STREAM_FIXES 64
+
+typedef struct {
+    uint32_t sentences;
+    uint32_t gga;
+} counts_t;
+
+static void on_fields(void *ctx, const nmea_fields_t *f) {
+    counts_t *c = ctx;
+    c->sentences++;
+    c->gga += f->type == NMEA_TYPE_GGA;
+}
+
+/* The pre-tokenizer path: copy, strtok_r (which drops empty fields), strstr. */
+static void on_sentence_strtok(void *ctx, const nmea_fields_t *f) {
+    counts_t *c = ctx;
+    char copy[NMEA_MAX_LEN];
+    char *tokens[NMEA_MAX_FIELDS];
+    char *saveptr;
+    int n = 0;
+
+    strncpy(copy, f->base, NMEA_MAX_LEN - 1);
+    copy[NMEA_MAX_LEN - 1] = '\0';
+    for (char *p = strtok_r(copy, ",", &saveptr); p && n < NMEA_MAX_FIELDS; p = strtok_r(NULL, ",", &saveptr)) {
+        tokens[n++] = p;
+    }
+    c->sentences++;
+    c->gga += n > 0 && strstr(tokens[0], "GGA") != NULL;
+}
+
+static void report(const char *name, uint64_t ns, double bytes, double items, const char *unit) {
+    printf("  %-40s %8.1f MB/s %8.1f ns/%s\n", name, bytes * 1e3 / ns, ns / items, unit);
+}
+
+int main(int argc, char **argv) {
+    int rounds = bench_iterations(argc, argv, 20000);
+    static const char burst[] = NMEA_FIX_BURST;
+    size_t burst_len = sizeof(burst) - 1;
+    size_t stream_len = burst_len * STREAM_FIXES;
+    uint8_t *stream = malloc(stream_len);
+    for (int i = 0; i < STREAM_FIXES; i++) memcpy(stream + i * burst_len, burst, burst_len);
+
+    nmea_reader_t rd;
+    counts_t fields = { 0, 0 }, strtok = { 0, 0 };
+    double bytes = (double)stream_len * rounds;
+    double sentences = 4.0 * STREAM_FIXES * rounds;
+
+    printf("NMEA, %zu-byte fix bursts:\n", burst_len);
+    nmea_reader_init(&rd);
+    uint64_t t0 = bench_now_ns();
+    for (int r = 0; r < rounds; r++) nmea_feed(&rd, stream, stream_len, on_fields, &fields);
+    report("nmea_feed (frame + tokenize)", bench_now_ns() - t0, bytes, sentences, "sentence");
+
+    nmea_reader_init(&rd);
+    t0 = bench_now_ns();
+    for (int r = 0; r < rounds; r++) nmea_feed(&rd, stream, stream_len, on_sentence_strtok, &strtok);
+    report("nmea_feed + copy/strtok_r/strstr", bench_now_ns() - t0, bytes, sentences, "sentence");
+
+    if (fields.sentences != sentences || fields.gga != strtok.gga || rd.checksum_errors) {
+        fprintf(stderr, "stream mis-parsed: %u sentences, %u/%u GGA, %u checksum errors\n",
+                (unsigned)fields.sentences, (unsigned)fields.gga, (unsigned)strtok.gga, (unsigned)rd.checksum_errors);
+        return EXIT_FAILURE;
+    }
+
+    long calls = (long)rounds * 100;
+    int32_t e7;
+    t0 = bench_now_ns();
+    for (long i = 0; i < calls; i++) {
+        nmea_parse_coord("00630.3372", 10, (i & 1) ? 'W' : 'E', &e7);
+        bench_sink += e7;
+    }
+    report("nmea_parse_coord", bench_now_ns() - t0, 10.0 * calls, calls, "call");
+
+    int64_t us;
+    t0 = bench_now_ns();
+    for (long i = 0; i < calls; i++) {
+        nmea_parse_utc("092750.000", 10, "280511", 6, &us);
+        bench_sink += us;
+    }
+    report("nmea_parse_utc", bench_now_ns() - t0, 16.0 * calls, calls, "call");
+
+    free(stream);
+    return EXIT_SUCCESS;
+}
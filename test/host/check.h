@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Minimal assertion helpers for the host tests; a failure exits non-zero. */
+static int check_failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+        check_failures++; \
+    } \
+} while (0)
+
+#define CHECK_EQ(a, b) do { \
+    long long check_a_ = (long long)(a), check_b_ = (long long)(b); \
+    if (check_a_ != check_b_) { \
+        fprintf(stderr, "%s:%d: CHECK_EQ failed: %s = %lld, %s = %lld\n", \
+                __FILE__, __LINE__, #a, check_a_, #b, check_b_); \
+        check_failures++; \
+    } \
+} while (0)
+
+static inline int check_report(const char *name) {
+    if (check_failures) {
+        fprintf(stderr, "%s: %d failure(s)\n", name, check_failures);
+        return EXIT_FAILURE;
+    }
+    printf("%s: ok\n", name);
+    return EXIT_SUCCESS;
+}
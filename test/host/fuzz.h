@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Fuzz targets use the libFuzzer entry point, so they build either against
+ * libFuzzer (-DHOST_LIBFUZZER=ON, clang) or against fuzz_main.c, a small
+ * deterministic mutator over the target's seeds that ctest runs under
+ * ASan/UBSan. A target reports a broken invariant with FUZZ_CHECK, which
+ * aborts; the standalone driver then saves the input to fuzz-crash.bin.
+ */
+#define FUZZ_CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: invariant failed: %s\n", __FILE__, __LINE__, #cond); \
+        abort(); \
+    } \
+} while (0)
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+} fuzz_seed_t;
+
+/* Starting inputs for the standalone driver. */
+extern const fuzz_seed_t fuzz_seeds[];
+extern const int fuzz_seed_count;
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
@@ -0,0 +1,136 @@
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#if defined(__SANITIZE_ADDRESS__)
+#include <sanitizer/common_interface_defs.h>
+#endif
+
+#include "bench.h"
+#include "fuzz.h"
+
+/*
+ * Standalone driver: `fuzz_x [--runs N] [file...]` replays each file, then
+ * runs N mutated seeds. Every input is copied to an exactly-sized heap block
+ * so ASan reports any read past its end. An input that aborts or trips a
+ * sanitizer is written to fuzz-crash.bin; pass that file to replay it.
+ */
+#define MAX_INPUT 1024
+
+static const uint8_t interesting[] = { 0x00, 0x01, 0x02, 0x7F, 0x80, 0xFE, 0xFF, '$', '*', ',', '\r', '\n' };
+
+static const uint8_t *current;
+static size_t current_len;
+
+/* Runs from a signal handler or the sanitizer's death callback: syscalls only. */
+static void save_current(void) {
+    int fd = open("fuzz-crash.bin", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return;
+    if (write(fd, current, current_len) < 0) {
+        /* nothing more to do on the way down */
+    }
+    close(fd);
+}
+
+static void on_abort(int sig) {
+    save_current();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+static void run_one(const uint8_t *data, size_t len) {
+    uint8_t *copy = malloc(len ? len : 1);
+    memcpy(copy, data, len);
+    current = copy;
+    current_len = len;
+    LLVMFuzzerTestOneInput(copy, len);
+    free(copy);
+}
+
+static size_t mutate(uint8_t *buf, size_t len, uint64_t *rng) {
+    int edits = 1 + bench_rand(rng) % 8;
+    for (int e = 0; e < edits; e++) {
+        size_t pos = len ? bench_rand(rng) % len : 0;
+        switch (bench_rand(rng) % 6) {
+        case 0:
+            if (len) buf[pos] ^= 1u << (bench_rand(rng) % 8);
+            break;
+        case 1:
+            if (len) buf[pos] = interesting[bench_rand(rng) % sizeof(interesting)];
+            break;
+        case 2:
+            if (len) buf[pos] = (uint8_t)bench_rand(rng);
+            break;
+        case 3:
+            if (len < MAX_INPUT) {
+                memmove(buf + pos + 1, buf + pos, len - pos);
+                buf[pos] = (uint8_t)bench_rand(rng);
+                len++;
+            }
+            break;
+        case 4:
+            if (len) {
+                memmove(buf + pos, buf + pos + 1, len - pos - 1);
+                len--;
+            }
+            break;
+        case 5: {
+            /* Splice in a piece of another seed. */
+            const fuzz_seed_t *s = &fuzz_seeds[bench_rand(rng) % fuzz_seed_count];
+            if (s->len == 0) break;
+            size_t from = bench_rand(rng) % s->len;
+            size_t n = 1 + bench_rand(rng) % (s->len - from);
+            if (pos + n > MAX_INPUT) n = MAX_INPUT - pos;
+            memcpy(buf + pos, s->data + from, n);
+            if (pos + n > len) len = pos + n;
+            break;
+        }
+        }
+    }
+    return len;
+}
+
+static int run_file(const char *path) {
+    static uint8_t buf[1 << 16];
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    size_t len = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    run_one(buf, len);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    long runs = 100000;
+    uint64_t rng = 0x2545F4914F6CDD1Dull;
+    uint8_t buf[MAX_INPUT];
+
+    signal(SIGABRT, on_abort);
+#if defined(__SANITIZE_ADDRESS__)
+    __sanitizer_set_death_callback(save_current);
+#endif
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = strtol(argv[++i], NULL, 10);
+        } else if (run_file(argv[i]) != 0) {
+            return EXIT_FAILURE;
+        }
+    }
+    for (int i = 0; i < fuzz_seed_count; i++) run_one(fuzz_seeds[i].data, fuzz_seeds[i].len);
+    for (long r = 0; r < runs; r++) {
+        const fuzz_seed_t *s = &fuzz_seeds[bench_rand(&rng) % fuzz_seed_count];
+        size_t len = s->len < MAX_INPUT ? s->len : MAX_INPUT;
+        memcpy(buf, s->data, len);
+        len = mutate(buf, len, &rng);
+        /* Truncation is the common real-world damage; try a prefix too. */
+        run_one(buf, len);
+        if (len) run_one(buf, bench_rand(&rng) % len);
+    }
+    printf("%s: %ld mutated inputs ok\n", argv[0], runs);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "fuzz.h"
+#include "nmea.h"
+#include "nmea_samples.h"
+
+/*
+ * NMEA framer, tokenizer and field parsers on arbitrary byte streams.
+ * Beyond memory safety: every delivered sentence is NUL-terminated within
+ * the buffer, its fields lie inside it and hold no separators, the
+ * coordinate and time parsers stay in range on any field, and feeding the
+ * stream in arbitrary chunks delivers exactly what one call does.
+ */
+#define SEED(s) { (const uint8_t *)(s), sizeof(s) - 1 }
+
+const fuzz_seed_t fuzz_seeds[] = {
+    SEED(NMEA_GGA_FIX),
+    SEED(NMEA_GGA_NOFIX),
+    SEED(NMEA_RMC),
+    SEED(NMEA_FIX_BURST),
+    SEED(NMEA_PMTK_ACK NMEA_GSV),
+    SEED("$GPGGA,0000" NMEA_RMC),
+};
+const int fuzz_seed_count = sizeof(fuzz_seeds) / sizeof(fuzz_seeds[0]);
+
+typedef struct {
+    uint32_t sentences;
+    uint32_t digest;
+} delivery_t;
+
+static void check_sentence(void *ctx, const nmea_fields_t *f) {
+    delivery_t *d = ctx;
+    size_t body = strnlen(f->base, NMEA_MAX_LEN);
+    FUZZ_CHECK(body < NMEA_MAX_LEN && f->count > 0 && f->count <= NMEA_MAX_FIELDS);
+
+    for (int i = 0; i < f->count; i++) {
+        int len;
+        const char *p = nmea_field(f, i, &len);
+        FUZZ_CHECK(p >= f->base && p + len <= f->base + body);
+        FUZZ_CHECK(!memchr(p, ',', len) && !memchr(p, '*', len));
+
+        int32_t e7;
+        int hemi_len;
+        const char *hemi = nmea_field(f, i + 1, &hemi_len);
+        if (nmea_parse_coord(p, len, hemi_len ? hemi[0] : 'N', &e7)) FUZZ_CHECK(e7 <= 1800000000 && e7 >= -1800000000);
+
+        int64_t us;
+        int date_len;
+        const char *date = nmea_field(f, i + 1, &date_len);
+        /* 2000-01-01 .. 2100-01-01 */
+        if (date && nmea_parse_utc(p, len, date, date_len, &us)) {
+            FUZZ_CHECK(us >= 946684800000000ll && us < 4102444800000000ll);
+        }
+    }
+    int past_len;
+    FUZZ_CHECK(nmea_field(f, f->count, &past_len) == NULL && past_len == 0);
+
+    d->sentences++;
+    for (size_t i = 0; i < body; i++) d->digest = (d->digest ^ (uint8_t)f->base[i]) * 16777619u;
+    d->digest = (d->digest ^ f->count) * 16777619u;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    nmea_reader_t whole, chunked;
+    delivery_t a = { 0, 2166136261u }, b = { 0, 2166136261u };
+
+    nmea_reader_init(&whole);
+    nmea_feed(&whole, data, size, check_sentence, &a);
+
+    /* Chunk sizes 1..16 drawn from the input itself, so a crash reproduces from the file alone. */
+    nmea_reader_init(&chunked);
+    uint32_t split = 2166136261u;
+    for (size_t i = 0; i < size; i++) split = (split ^ data[i]) * 16777619u;
+    for (size_t off = 0; off < size;) {
+        size_t n = 1 + (split & 15);
+        split = split * 1103515245u + 12345u;
+        if (n > size - off) n = size - off;
+        nmea_feed(&chunked, data + off, n, check_sentence, &b);
+        off += n;
+    }
+
+    FUZZ_CHECK(a.sentences == b.sentences && a.digest == b.digest);
+    FUZZ_CHECK(whole.sentences == chunked.sentences && whole.sentences == a.sentences);
+    FUZZ_CHECK(whole.checksum_errors == chunked.checksum_errors && whole.overruns == chunked.overruns);
+    return 0;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+/* Checksummed NMEA sentences as a GPS module sends them. */
+#define NMEA_GGA_FIX "$GPGGA,092750.000,5321.6802,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,*76\r\n"
+#define NMEA_GGA_NOFIX "$GNGGA,,,,,,0,00,25.5,,,,,,*64\r\n"
+#define NMEA_RMC "$GPRMC,092750.000,A,5321.6802,N,00630.3372,W,0.02,31.66,280511,,,A*43\r\n"
+/* Before a fix: status V and the module's GPS-epoch default date, read as 2080. */
+#define NMEA_RMC_VOID "$GPRMC,000012.800,V,,,,,0.00,0.00,060180,,,N*49\r\n"
+#define NMEA_RMC_EPOCH_ACTIVE "$GPRMC,000012.800,A,,,,,0.00,0.00,060180,,,N*5E\r\n"
+#define NMEA_RMC_2026 "$GNRMC,101530.000,A,5321.6802,N,00630.3372,W,0.02,31.66,180926,,,A*59\r\n"
+#define NMEA_RMC_2018 "$GPRMC,101530.000,A,5321.6802,N,00630.3372,W,0.02,31.66,180918,,,A*4A\r\n"
+#define NMEA_GSV "$GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30*70\r\n"
+#define NMEA_GSA "$GPGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38*0A\r\n"
+#define NMEA_PMTK_ACK "$PMTK001,220,3*30\r\n"
+
+/* One fix's worth of output from a module left at its default sentence set. */
+#define NMEA_FIX_BURST NMEA_GGA_FIX NMEA_GSA NMEA_GSV NMEA_RMC
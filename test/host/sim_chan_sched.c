@@ -0,0 +1,141 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "bench.h"
+#include "chan_sched.h"
+#include "check.h"
+#include "esp_wifi_types.h"
+
+/*
+ * Discoveries per hour of the UCB dwell split against round-robin (every
+ * dwell gets SNIFF_TIME_MS, as with ADAPTIVE_DWELL 0) on a simulated
+ * neighbourhood. Each tuning holds stations that arrive, leave and transmit
+ * at their own rate; a dwell discovers each present, not yet seen station
+ * with probability 1 - exp(-rate * dwell). Half-way through, the busiest
+ * tuning goes quiet and a quiet one gets busy, so the scheduler has to
+ * notice the change. Both policies see the same arrivals.
+ */
+#define SIM_HOURS 24
+#define CYCLE_S 60
+#define SNIFF_TIME_MS 3000
+#define MIN_DWELL_MS 1000
+#define MAX_STATIONS 512
+
+typedef struct {
+    uint8_t channel;
+    uint8_t second;
+    float arrivals_per_min;
+    float lifetime_min;
+} tuning_t;
+
+static const tuning_t tunings[] = {
+    { 1, WIFI_SECOND_CHAN_NONE, 3.0f, 5 },      /* cafe hotspot, short visits; closes half-way */
+    { 6, WIFI_SECOND_CHAN_NONE, 0.5f, 30 },
+    { 6, WIFI_SECOND_CHAN_ABOVE, 0.2f, 60 },
+    { 11, WIFI_SECOND_CHAN_NONE, 0.2f, 120 },
+    { 36, WIFI_SECOND_CHAN_NONE, 0.05f, 240 },
+    { 36, WIFI_SECOND_CHAN_ABOVE, 2.0f, 10 },   /* busy HT40 guest network next to a quiet HT20 AP */
+    { 44, WIFI_SECOND_CHAN_NONE, 0.05f, 480 },
+    { 100, WIFI_SECOND_CHAN_NONE, 0.02f, 480 },
+    { 149, WIFI_SECOND_CHAN_ABOVE, 0.05f, 120 },/* gets busy half-way */
+    { 157, WIFI_SECOND_CHAN_NONE, 0.01f, 480 },
+};
+#define TUNINGS (int)(sizeof(tunings) / sizeof(tunings[0]))
+
+typedef struct {
+    float tx_per_s;
+    bool seen;
+} station_t;
+
+typedef struct {
+    station_t sta[TUNINGS][MAX_STATIONS];
+    int count[TUNINGS];
+    long arrivals;
+    uint64_t rng;
+} world_t;
+
+static double uniform(uint64_t *rng) {
+    return (bench_rand(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int poisson(uint64_t *rng, double mean) {
+    double limit = exp(-mean), p = 1.0;
+    int k = 0;
+    while ((p *= uniform(rng)) > limit) k++;
+    return k;
+}
+
+/* Stations come and go on the world's own stream, so both policies see the same population. */
+static void world_step(world_t *w, int cycle) {
+    bool late = cycle >= SIM_HOURS * 60 / 2;
+    for (int t = 0; t < TUNINGS; t++) {
+        float arrivals = tunings[t].arrivals_per_min;
+        if (late && t == 0) arrivals = 0.05f;
+        if (late && t == 8) arrivals = 3.0f;
+        double leave = 1.0 - exp(-(double)CYCLE_S / 60.0 / tunings[t].lifetime_min);
+        for (int i = 0; i < w->count[t];) {
+            if (uniform(&w->rng) < leave) w->sta[t][i] = w->sta[t][--w->count[t]];
+            else i++;
+        }
+        for (int n = poisson(&w->rng, arrivals * CYCLE_S / 60.0); n > 0 && w->count[t] < MAX_STATIONS; n--) {
+            /* Log-uniform 0.01..2 frames/s: mostly idle phones, a few busy laptops. */
+            w->sta[t][w->count[t]++] = (station_t){ .tx_per_s = 0.01f * powf(200.0f, uniform(&w->rng)) };
+            w->arrivals++;
+        }
+    }
+}
+
+static int sniff(world_t *w, int t, uint32_t dwell_ms, uint64_t *rng) {
+    int found = 0;
+    for (int i = 0; i < w->count[t]; i++) {
+        station_t *s = &w->sta[t][i];
+        if (!s->seen && uniform(rng) < 1.0 - exp(-s->tx_per_s * dwell_ms / 1000.0)) {
+            s->seen = true;
+            found++;
+        }
+    }
+    return found;
+}
+
+static double run(bool adaptive, double *arrivals_per_h) {
+    static world_t w;
+    uint64_t capture_rng = 0xA0761D6478BD642Full;
+    uint8_t channels[TUNINGS], seconds[TUNINGS];
+    uint32_t dwell_ms[TUNINGS];
+    long total = 0;
+
+    for (int t = 0; t < TUNINGS; t++) {
+        channels[t] = tunings[t].channel;
+        seconds[t] = tunings[t].second;
+        w.count[t] = 0;
+    }
+    w.arrivals = 0;
+    w.rng = 0x9E3779B97F4A7C15ull;
+
+    for (int cycle = 0; cycle < SIM_HOURS * 60 * 60 / CYCLE_S; cycle++) {
+        world_step(&w, cycle);
+        for (int t = 0; t < TUNINGS; t++) dwell_ms[t] = SNIFF_TIME_MS;
+        if (adaptive) chan_sched_allocate(channels, seconds, TUNINGS, TUNINGS * SNIFF_TIME_MS, MIN_DWELL_MS, dwell_ms);
+        for (int t = 0; t < TUNINGS; t++) {
+            int found = sniff(&w, t, dwell_ms[t], &capture_rng);
+            if (adaptive) chan_sched_update(channels[t], seconds[t], dwell_ms[t], found);
+            total += found;
+        }
+    }
+    *arrivals_per_h = (double)w.arrivals / SIM_HOURS;
+    return (double)total / SIM_HOURS;
+}
+
+int main(void) {
+    double arrivals;
+    double rr = run(false, &arrivals);
+    double ucb = run(true, &arrivals);
+    printf("%d h, %d tunings, %d ms sniff per tuning per %d s cycle, %.1f stations/h arrive:\n", SIM_HOURS,
+           TUNINGS, SNIFF_TIME_MS, CYCLE_S, arrivals);
+    printf("  round-robin %8.1f discoveries/h\n", rr);
+    printf("  UCB         %8.1f discoveries/h (%.2fx)\n", ucb, ucb / rr);
+    chan_sched_print_report();
+    CHECK(ucb > rr);
+    return check_report("sim_chan_sched");
+}
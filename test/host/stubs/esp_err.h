@@ -0,0 +1,9 @@
+#pragma once
+
+/* Host stand-in for the ESP-IDF header: only what main/ modules use. */
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_NO_MEM 0x101
+#define ESP_ERR_NOT_FOUND 0x105
@@ -0,0 +1,11 @@
+#pragma once
+
+/* Host stand-in for the ESP-IDF header: plain malloc, unlimited heap. */
+#include <stdlib.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+static inline size_t heap_caps_get_free_size(uint32_t caps) { return SIZE_MAX / 2; }
+static inline size_t heap_caps_get_total_size(uint32_t caps) { return SIZE_MAX / 2; }
+static inline void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) { return calloc(n, size); }
@@ -0,0 +1,194 @@
+#include <math.h>
+#include <stdio.h>
+
+#include "ap_locate.h"
+#include "bench.h"
+#include "check.h"
+
+/*
+ * AP location: the integer centroid and radius against double precision,
+ * and the estimate from synthetic drive-by tracks whose RSSI follows a
+ * log-distance path-loss model with shadowing, against the true AP spot.
+ */
+#define M_PER_E7 0.01112            /* metres per 1e-7 degree of latitude */
+
+typedef struct {
+    double w, lat, lon, lat_sq, lon_sq;
+} ref_locate_t;
+
+static void ref_add(ref_locate_t *r, int32_t anchor_lat, int32_t anchor_lon, int32_t lat, int32_t lon, int rssi) {
+    int shift = (rssi + 100) / 6;
+    double w = ldexp(1.0, shift < 0 ? 0 : shift > 10 ? 10 : shift);
+    double dlat = lat - anchor_lat, dlon = lon - anchor_lon;
+    r->w += w;
+    r->lat += w * dlat;
+    r->lon += w * dlon;
+    r->lat_sq += w * dlat * dlat;
+    r->lon_sq += w * dlon * dlon;
+}
+
+/* Scatter around a point at several latitudes; estimate within a unit, radius within 0.5%. */
+static void test_locate_vs_double(void) {
+    static const int32_t latitudes[] = { 0, 300000000, 515000000, -600000000, 780000000 };
+    uint64_t rng = 0xDA942042E4DD58B5ull;
+
+    for (size_t k = 0; k < sizeof(latitudes) / sizeof(latitudes[0]); k++) {
+        ap_locate_t loc = { 0 };
+        ref_locate_t ref = { 0 };
+        int32_t lat0 = latitudes[k], lon0 = 169000000;
+        int32_t first_lat = 0, first_lon = 0;
+
+        /* Few enough strong samples that the weight total never halves. */
+        for (int i = 0; i < 900; i++) {
+            int32_t lat = lat0 + (int32_t)(bench_rand(&rng) % 4001) - 2000;
+            int32_t lon = lon0 + (int32_t)(bench_rand(&rng) % 8001) - 4000;
+            int rssi = -95 + (int)(bench_rand(&rng) % 60);
+            if (i == 0) {
+                first_lat = lat;
+                first_lon = lon;
+            }
+            CHECK(ap_locate_add(&loc, lat, lon, rssi));
+            ref_add(&ref, first_lat, first_lon, lat, lon, rssi);
+        }
+        CHECK(loc.sum_w == ref.w);
+
+        ap_locate_estimate_t est;
+        CHECK(ap_locate_estimate(&loc, &est));
+        double mean_lat = ref.lat / ref.w, mean_lon = ref.lon / ref.w;
+        CHECK(fabs(est.lat_e7 - (first_lat + mean_lat)) <= 0.5 + 1e-9);
+        CHECK(fabs(est.lon_e7 - (first_lon + mean_lon)) <= 0.5 + 1e-9);
+
+        double c = cos(est.lat_e7 * 1e-7 * M_PI / 180.0);
+        double var = ref.lat_sq / ref.w - mean_lat * mean_lat + (ref.lon_sq / ref.w - mean_lon * mean_lon) * c * c;
+        double radius = sqrt(var) * 0.01112;
+        if (fabs(est.radius_m - radius) > radius * 0.005 + 0.5) {
+            fprintf(stderr, "lat %.1f: radius %u m, reference %.2f m\n", lat0 * 1e-7, (unsigned)est.radius_m, radius);
+            CHECK(false);
+        }
+    }
+}
+
+/* East-west spread only: the radius is the longitude spread scaled by cos(lat). */
+static void test_locate_longitude_scale(void) {
+    for (int deg = 0; deg <= 85; deg += 5) {
+        ap_locate_t loc = { 0 };
+        int32_t lat = deg * 10000000;
+        ap_locate_add(&loc, lat, -900000, -50);
+        ap_locate_add(&loc, lat, -1100000, -50);
+
+        ap_locate_estimate_t est;
+        CHECK(ap_locate_estimate(&loc, &est));
+        CHECK_EQ(est.lon_e7, -1000000);
+        /* 100000 e7 of longitude at the equator is 1112 m. */
+        double expected = 1112.0 * cos(deg * M_PI / 180.0);
+        if (fabs(est.radius_m - expected) > expected * 0.005 + 1.0) {
+            fprintf(stderr, "lat %d: radius %u m, expected %.1f m\n", deg, (unsigned)est.radius_m, expected);
+            CHECK(false);
+        }
+    }
+}
+
+static void test_locate_bookkeeping(void) {
+    ap_locate_t loc = { 0 };
+    ap_locate_estimate_t est;
+
+    CHECK(!ap_locate_estimate(&loc, &est));
+    CHECK(ap_locate_add(&loc, 500000000, 100000000, -80));
+    CHECK(ap_locate_add(&loc, 500000100, 100000100, -40));
+    CHECK(ap_locate_add(&loc, 500000200, 100000200, -70));
+    CHECK(!ap_locate_add(&loc, 500000000 + AP_LOCATE_MAX_SPAN_E7 + 1, 100000000, -30));
+    CHECK_EQ(loc.samples, 3);
+    CHECK_EQ(loc.outliers, 1);
+    CHECK_EQ(loc.best_rssi, -40);
+    CHECK_EQ(loc.best_lat_e7, 500000100);
+    CHECK_EQ(loc.best_lon_e7, 100000100);
+
+    /* One spot heard forever: halving keeps the sums bounded and the estimate exact. */
+    ap_locate_t still = { 0 };
+    for (int i = 0; i < 100000; i++) ap_locate_add(&still, -337000000, 1512000000, -20);
+    CHECK(still.sum_w <= AP_LOCATE_MAX_WEIGHT);
+    CHECK(ap_locate_estimate(&still, &est));
+    CHECK_EQ(est.lat_e7, -337000000);
+    CHECK_EQ(est.lon_e7, 1512000000);
+    CHECK_EQ(est.radius_m, 0);
+}
+
+/* Log-distance path loss: -40 dBm at 1 m, exponent 2.7, uniform +-SHADOW_DB shadowing. */
+#define PATH_LOSS_1M_DBM -40.0
+#define PATH_LOSS_EXPONENT 2.7
+#define SHADOW_DB 4
+#define RX_FLOOR_DBM -92            /* weaker frames are never heard */
+
+typedef struct {
+    double x0, y0, x1, y1;          /* metres east/north of the AP */
+} leg_t;
+
+typedef struct {
+    double error_m;                 /* estimate to the true AP */
+    double plain_error_m;           /* unweighted mean of the heard points */
+    int heard;
+} drive_t;
+
+/* Drives the legs at one track point every `step_m`, feeding every point the AP is heard at. */
+static drive_t drive_by(const leg_t *legs, int n, double step_m, int32_t ap_lat, int32_t ap_lon, uint64_t seed) {
+    double lon_m = M_PER_E7 * cos(ap_lat * 1e-7 * M_PI / 180.0);
+    ap_locate_t loc = { 0 };
+    drive_t out = { 0 };
+    double sum_x = 0, sum_y = 0;
+
+    for (int l = 0; l < n; l++) {
+        double len = hypot(legs[l].x1 - legs[l].x0, legs[l].y1 - legs[l].y0);
+        for (double t = 0; t <= len; t += step_m) {
+            double x = legs[l].x0 + (legs[l].x1 - legs[l].x0) * t / len;
+            double y = legs[l].y0 + (legs[l].y1 - legs[l].y0) * t / len;
+            double d = hypot(x, y);
+            double rssi = PATH_LOSS_1M_DBM - 10 * PATH_LOSS_EXPONENT * log10(d < 1 ? 1 : d) +
+                          (int)(bench_rand(&seed) % (2 * SHADOW_DB + 1)) - SHADOW_DB;
+            if (rssi < RX_FLOOR_DBM) continue;
+            int32_t lat = ap_lat + (int32_t)lround(y / M_PER_E7);
+            int32_t lon = ap_lon + (int32_t)lround(x / lon_m);
+            CHECK(ap_locate_add(&loc, lat, lon, (int8_t)lround(rssi)));
+            sum_x += x;
+            sum_y += y;
+            out.heard++;
+        }
+    }
+
+    ap_locate_estimate_t est;
+    CHECK(ap_locate_estimate(&loc, &est));
+    out.error_m = hypot((est.lat_e7 - ap_lat) * M_PER_E7, (est.lon_e7 - ap_lon) * lon_m);
+    out.plain_error_m = out.heard ? hypot(sum_x / out.heard, sum_y / out.heard) : INFINITY;
+    return out;
+}
+
+/* Within max_error_m of the AP, and closer than an unweighted mean of the same points. */
+static void check_drive(const char *name, drive_t d, double max_error_m) {
+    if (d.heard <= 20 || d.error_m > max_error_m || d.error_m >= d.plain_error_m) {
+        fprintf(stderr, "%s: %d points, error %.1f m (limit %.0f m), unweighted mean %.1f m\n", name, d.heard,
+                d.error_m, max_error_m, d.plain_error_m);
+        CHECK(false);
+    }
+}
+
+static void test_drive_by(void) {
+    static const int32_t latitudes[] = { 0, 515000000, -337000000, 700000000 };
+    /* A straight road 25 m south of the AP, starting just before it. */
+    static const leg_t road[] = { { -60, -25, 600, -25 } };
+    /* Around the block: the same road, then back on a parallel street 40 m north. */
+    static const leg_t block[] = { { -60, -25, 300, -25 }, { 300, -25, 300, 40 }, { 300, 40, -300, 40 } };
+
+    for (size_t k = 0; k < sizeof(latitudes) / sizeof(latitudes[0]); k++) {
+        int32_t lat = latitudes[k], lon = 169000000;
+        /* One road only: the centroid stays on it, so allow the 25 m offset plus along-track slack. */
+        check_drive("straight road", drive_by(road, 1, 2.0, lat, lon, 0x9E3779B97F4A7C15ull + k), 35.0);
+        check_drive("around the block", drive_by(block, 3, 2.0, lat, lon, 0xC2B2AE3D27D4EB4Full + k), 15.0);
+    }
+}
+
+int main(void) {
+    test_locate_vs_double();
+    test_locate_longitude_scale();
+    test_locate_bookkeeping();
+    test_drive_by();
+    return check_report("test_ap_locate");
+}
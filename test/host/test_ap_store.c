@@ -0,0 +1,250 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "ap_store.h"
+#include "check.h"
+
+#define IMAGE_SECTORS 16
+
+/* File-backed partition image with NOR semantics: erase to 0xFF, writes only clear bits. */
+static bool image_read(void *ctx, uint32_t offset, void *buf, size_t len) {
+    FILE *f = ctx;
+    return fseek(f, offset, SEEK_SET) == 0 && fread(buf, 1, len, f) == len;
+}
+
+static bool image_write(void *ctx, uint32_t offset, const void *buf, size_t len) {
+    uint8_t old[256];
+    const uint8_t *src = buf;
+    while (len > 0) {
+        size_t n = len < sizeof(old) ? len : sizeof(old);
+        if (!image_read(ctx, offset, old, n)) return false;
+        for (size_t i = 0; i < n; i++) old[i] &= src[i];
+        if (fseek(ctx, offset, SEEK_SET) != 0 || fwrite(old, 1, n, ctx) != n) return false;
+        offset += n;
+        src += n;
+        len -= n;
+    }
+    return true;
+}
+
+static bool image_erase(void *ctx, uint32_t offset, size_t len) {
+    static const uint8_t erased[AP_STORE_SECTOR_SIZE] = { [0 ... AP_STORE_SECTOR_SIZE - 1] = 0xFF };
+    for (size_t done = 0; done < len; done += AP_STORE_SECTOR_SIZE) {
+        if (fseek(ctx, offset + done, SEEK_SET) != 0 || fwrite(erased, 1, sizeof(erased), ctx) != sizeof(erased)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static ap_store_flash_t new_image(void) {
+    FILE *f = tmpfile();
+    ap_store_flash_t flash = {
+        .ctx = f,
+        .size = IMAGE_SECTORS * AP_STORE_SECTOR_SIZE,
+        .read = image_read,
+        .write = image_write,
+        .erase = image_erase,
+    };
+    image_erase(f, 0, flash.size);
+    return flash;
+}
+
+static void make_mac(uint8_t mac[6], uint32_t n) {
+    mac[0] = 0x02;
+    mac[1] = 0x11;
+    mac[2] = n >> 24;
+    mac[3] = n >> 16;
+    mac[4] = n >> 8;
+    mac[5] = n;
+}
+
+/* Keys from an earlier boot must not look newer than this boot's, whatever the uptime. */
+static void test_reboot_keeps_recent_keys(void) {
+    ap_store_flash_t flash = new_image();
+    ap_store_t st;
+    uint8_t mac[6];
+
+    CHECK(ap_store_open(&st, &flash, 8, 8));
+    for (uint32_t i = 0; i < 8; i++) {
+        make_mac(mac, i);
+        CHECK(ap_store_log_ap(&st, ap_store_time(&st, 1000 + i * 60, 0), mac, "old", 6, -60, 3, NULL));
+    }
+    uint32_t last_boot_time = ap_store_time(&st, 2000, 0);
+    ap_store_close(&st);
+
+    /* Reboot: uptime restarts near zero, no wall clock. */
+    CHECK(ap_store_open(&st, &flash, 8, 8));
+    CHECK(ap_store_time(&st, 0, 0) > last_boot_time - 1000);
+    for (uint32_t i = 100; i < 104; i++) {
+        make_mac(mac, i);
+        CHECK(ap_store_log_ap(&st, ap_store_time(&st, 5 + i - 100, 0), mac, "new", 11, -50, 3, NULL));
+    }
+    for (uint32_t i = 100; i < 104; i++) {
+        make_mac(mac, i);
+        CHECK(ap_store_find_ap(&st, mac) != NULL);
+    }
+    /* The four oldest keys of the previous boot made room. */
+    int survivors = 0;
+    for (uint32_t i = 0; i < 8; i++) {
+        make_mac(mac, i);
+        survivors += ap_store_find_ap(&st, mac) != NULL;
+    }
+    CHECK_EQ(survivors, 4);
+    ap_store_close(&st);
+    fclose(flash.ctx);
+}
+
+static void test_clock(void) {
+    ap_store_flash_t flash = new_image();
+    ap_store_t st;
+    uint8_t mac[6] = { 0x02, 0, 0, 0, 0, 1 };
+
+    CHECK(ap_store_open(&st, &flash, 4, 4));
+    uint32_t t0 = ap_store_time(&st, 10, 0);
+    CHECK_EQ(ap_store_time(&st, 20, 0), t0 + 10);
+    /* Wall time pulls the clock forward and it stays there. */
+    CHECK_EQ(ap_store_time(&st, 30, 1700000000), 1700000000);
+    CHECK_EQ(ap_store_time(&st, 40, 0), 1700000010);
+    CHECK_EQ(ap_store_time(&st, 50, 5), 1700000020);
+    CHECK(ap_store_log_ap(&st, ap_store_time(&st, 60, 0), mac, "x", 1, -40, 0, NULL));
+    ap_store_close(&st);
+
+    CHECK(ap_store_open(&st, &flash, 4, 4));
+    CHECK(ap_store_time(&st, 0, 0) > 1700000030);
+    ap_store_close(&st);
+    fclose(flash.ctx);
+}
+
+/* Many more keys than index entries, across compactions and a reopen. */
+static void test_index_churn(void) {
+    enum { CAPACITY = 64, KEYS = 3000 };
+    ap_store_flash_t flash = new_image();
+    ap_store_t st;
+    uint8_t bssid[6], client[6];
+
+    CHECK(ap_store_open(&st, &flash, CAPACITY, CAPACITY));
+    for (uint32_t i = 0; i < KEYS; i++) {
+        make_mac(bssid, i % 7);
+        make_mac(client, 1000 + i);
+        CHECK(ap_store_log_client(&st, ap_store_time(&st, i, 0), bssid, client, NULL));
+        if (ap_store_needs_compaction(&st)) ap_store_compact(&st);
+    }
+    ap_store_close(&st);
+
+    CHECK(ap_store_open(&st, &flash, CAPACITY, CAPACITY));
+    CHECK_EQ(st.client_count, CAPACITY);
+    /* The newest CAPACITY keys are indexed; logging them again writes nothing. */
+    uint32_t written = st.records_written;
+    uint32_t now = ap_store_time(&st, 0, 0);
+    for (uint32_t i = KEYS - CAPACITY; i < KEYS; i++) {
+        make_mac(bssid, i % 7);
+        make_mac(client, 1000 + i);
+        CHECK(ap_store_log_client(&st, now, bssid, client, NULL));
+    }
+    CHECK_EQ(st.records_written, written);
+    ap_store_close(&st);
+    fclose(flash.ctx);
+}
+
+/* A hot set that is re-sighted keeps its keys while one-off pairs stream past a full index. */
+static void test_hot_set_survives(void) {
+    enum { CAPACITY = 64, HOT = 48, ROUNDS = 200, COLD_PER_ROUND = 4 };
+    ap_store_flash_t flash = new_image();
+    ap_store_t st;
+    uint8_t bssid[6], client[6];
+
+    CHECK(ap_store_open(&st, &flash, CAPACITY, CAPACITY));
+    uint32_t cold = 0;
+    for (uint32_t r = 0; r < ROUNDS; r++) {
+        uint32_t now = ap_store_time(&st, r * 30, 0);
+        for (uint32_t i = 0; i < HOT; i++) {
+            make_mac(bssid, i % 16);
+            make_mac(client, i);
+            CHECK(ap_store_log_client(&st, now, bssid, client, NULL));
+        }
+        for (int i = 0; i < COLD_PER_ROUND; i++, cold++) {
+            make_mac(bssid, 500);
+            make_mac(client, 100000 + cold);
+            CHECK(ap_store_log_client(&st, now, bssid, client, NULL));
+        }
+        if (ap_store_needs_compaction(&st)) ap_store_compact(&st);
+    }
+
+    /* Only cold pairs were evicted, so hot pairs were written once plus refreshes, never as new. */
+    CHECK_EQ(st.keys_evicted, cold - (CAPACITY - HOT));
+    uint32_t refreshes = (ROUNDS * 30 - 1) / AP_STORE_REFRESH_SEC;
+    int hot_found = 0;
+    for (uint32_t i = 0; i < HOT; i++) {
+        make_mac(bssid, i % 16);
+        make_mac(client, i);
+        for (int e = 0; e < st.client_count; e++) {
+            const ap_store_client_t *c = &st.clients[e];
+            if (memcmp(c->bssid, bssid, 6) == 0 && memcmp(c->client, client, 6) == 0) {
+                hot_found++;
+                CHECK_EQ(c->first_seen, st.clock_base);
+                CHECK_EQ(c->sightings, 1 + refreshes);
+            }
+        }
+    }
+    CHECK_EQ(hot_found, HOT);
+    ap_store_close(&st);
+    fclose(flash.ctx);
+}
+
+/* Each record keeps the position it was heard at, through compaction and a reopen. */
+static void test_positions(void) {
+    ap_store_flash_t flash = new_image();
+    ap_store_t st;
+    uint8_t bssid[6], client[6];
+    ap_store_pos_t pos;
+
+    make_mac(bssid, 1);
+    make_mac(client, 2);
+    CHECK(ap_store_open(&st, &flash, 8, 8));
+    CHECK(ap_store_log_ap(&st, ap_store_time(&st, 0, 0), bssid, "geo", 6, -60, 3, NULL));
+    CHECK(ap_store_log_client(&st, ap_store_time(&st, 0, 0), bssid, client, NULL));
+    CHECK(!ap_store_read_ap_pos(&st, ap_store_find_ap(&st, bssid), &pos));
+    CHECK(!ap_store_read_client_pos(&st, ap_store_find_client(&st, bssid, client), &pos));
+
+    /* The first fix is written straight away, a later move waits for the refresh. */
+    uint32_t written = st.records_written;
+    ap_store_pos_t first = { 533613367, -63839533 }, moved = { -338688197, 1512092955 };
+    CHECK(ap_store_log_ap(&st, ap_store_time(&st, 10, 0), bssid, "geo", 6, -55, 3, &first));
+    CHECK(ap_store_log_client(&st, ap_store_time(&st, 10, 0), bssid, client, &first));
+    CHECK_EQ(st.records_written, written + 2);
+    CHECK(ap_store_log_ap(&st, ap_store_time(&st, 20, 0), bssid, "geo", 6, -50, 3, &moved));
+    CHECK(ap_store_log_client(&st, ap_store_time(&st, 20, 0), bssid, client, NULL));
+    CHECK_EQ(st.records_written, written + 2);
+    CHECK(ap_store_log_client(&st, ap_store_time(&st, 10 + AP_STORE_REFRESH_SEC, 0), bssid, client, &moved));
+    CHECK_EQ(st.records_written, written + 3);
+
+    for (uint32_t s = 0; s < IMAGE_SECTORS; s++) ap_store_compact(&st);
+    ap_store_close(&st);
+
+    CHECK(ap_store_open(&st, &flash, 8, 8));
+    const ap_store_ap_t *ap = ap_store_find_ap(&st, bssid);
+    const ap_store_client_t *c = ap_store_find_client(&st, bssid, client);
+    CHECK(ap && c);
+    CHECK(ap_store_read_ap_pos(&st, ap, &pos));
+    CHECK_EQ(pos.lat_e7, first.lat_e7);
+    CHECK_EQ(pos.lon_e7, first.lon_e7);
+    CHECK(ap_store_read_client_pos(&st, c, &pos));
+    CHECK_EQ(pos.lat_e7, moved.lat_e7);
+    CHECK_EQ(pos.lon_e7, moved.lon_e7);
+    CHECK_EQ(c->sightings, 3);
+    char ssid[8];
+    CHECK(ap_store_read_ssid(&st, ap, ssid, sizeof(ssid)));
+    CHECK(strcmp(ssid, "geo") == 0);
+    ap_store_close(&st);
+    fclose(flash.ctx);
+}
+
+int main(void) {
+    test_reboot_keeps_recent_keys();
+    test_clock();
+    test_index_churn();
+    test_hot_set_survives();
+    test_positions();
+    return check_report("test_ap_store");
+}
@@ -0,0 +1,66 @@
+#include "chan_sched.h"
+#include "check.h"
+#include "esp_wifi_types.h"
+
+#define MIN_DWELL_MS 1000
+
+/* A tuning that has never been sniffed gets spare time even next to a high-yield arm. */
+static void test_new_arm_is_sampled(void) {
+    uint8_t channels[2] = { 1, 6 };
+    uint8_t seconds[2] = { WIFI_SECOND_CHAN_NONE, WIFI_SECOND_CHAN_NONE };
+    uint32_t dwell_ms[2];
+
+    for (int cycle = 0; cycle < 10; cycle++) {
+        chan_sched_allocate(channels, seconds, 1, 6000, MIN_DWELL_MS, dwell_ms);
+        CHECK_EQ(dwell_ms[0], 6000);
+        chan_sched_update(1, WIFI_SECOND_CHAN_NONE, dwell_ms[0], 50);
+    }
+    chan_sched_allocate(channels, seconds, 2, 6000, MIN_DWELL_MS, dwell_ms);
+    CHECK_EQ(dwell_ms[0] + dwell_ms[1], 6000);
+    CHECK(dwell_ms[1] >= MIN_DWELL_MS + CHAN_SCHED_QUANTUM_MS);
+    CHECK(dwell_ms[0] > dwell_ms[1]);
+}
+
+/* HT20 and HT40 dwells on one primary keep separate estimates. */
+static void test_arms_keyed_by_tuning(void) {
+    uint8_t channels[2] = { 36, 36 };
+    uint8_t seconds[2] = { WIFI_SECOND_CHAN_NONE, WIFI_SECOND_CHAN_ABOVE };
+    uint32_t dwell_ms[2];
+
+    for (int cycle = 0; cycle < 20; cycle++) {
+        chan_sched_allocate(channels, seconds, 2, 8000, MIN_DWELL_MS, dwell_ms);
+        CHECK_EQ(dwell_ms[0] + dwell_ms[1], 8000);
+        chan_sched_update(36, WIFI_SECOND_CHAN_NONE, dwell_ms[0], 0);
+        chan_sched_update(36, WIFI_SECOND_CHAN_ABOVE, dwell_ms[1], dwell_ms[1] / 200);
+    }
+    CHECK(dwell_ms[1] > 2 * dwell_ms[0]);
+}
+
+/* More tunings than arms: the table recycles instead of failing, and budgets still add up. */
+static void test_arm_recycling(void) {
+    enum { N = CHAN_SCHED_MAX_ARMS / 2 };
+    uint8_t channels[N], seconds[N];
+    uint32_t dwell_ms[N];
+
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < N; i++) {
+            channels[i] = 100 + round * N + i;
+            seconds[i] = WIFI_SECOND_CHAN_NONE;
+        }
+        chan_sched_allocate(channels, seconds, N, N * 2000, MIN_DWELL_MS, dwell_ms);
+        uint32_t sum = 0;
+        for (int i = 0; i < N; i++) {
+            CHECK(dwell_ms[i] >= MIN_DWELL_MS);
+            sum += dwell_ms[i];
+            chan_sched_update(channels[i], seconds[i], dwell_ms[i], 1);
+        }
+        CHECK_EQ(sum, N * 2000);
+    }
+}
+
+int main(void) {
+    test_new_arm_is_sampled();
+    test_arms_keyed_by_tuning();
+    test_arm_recycling();
+    return check_report("test_chan_sched");
+}
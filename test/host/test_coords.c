@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "check.h"
+#include "nmea.h"
+
+/*
+ * NMEA coordinates: nmea_parse_coord against an exact rational reference,
+ * bit-exact including ties.
+ */
+
+/* Reference: the field is deg*100 + minutes; e7 = round((deg*60 + min) * 1e7 / 60), ties away from zero. */
+static bool ref_parse_coord(const char *p, int len, char hemisphere, int32_t *out_e7) {
+    const char *dot = memchr(p, '.', len);
+    int whole_len = dot ? (int)(dot - p) : len;
+    if (whole_len < 3 || whole_len > 5) return false;
+
+    __int128 whole = 0, frac = 0, scale = 1;
+    for (int i = 0; i < len; i++) {
+        if (p + i == dot) continue;
+        if (p[i] < '0' || p[i] > '9') return false;
+        if (i < whole_len) {
+            whole = whole * 10 + (p[i] - '0');
+        } else if (i - whole_len <= 9) {
+            /* Digits past the ninth fractional one are ignored, as documented. */
+            frac = frac * 10 + (p[i] - '0');
+            scale *= 10;
+        }
+    }
+    __int128 deg = whole / 100, min_whole = whole % 100;
+    if (min_whole >= 60) return false;
+
+    __int128 num = ((deg * 60 + min_whole) * scale + frac) * 10000000;
+    __int128 den = 60 * scale;
+    __int128 e7 = num / den;
+    if ((num % den) * 2 >= den) e7++;
+    if (e7 > 1800000000) return false;
+
+    if (hemisphere == 'S' || hemisphere == 'W') e7 = -e7;
+    else if (hemisphere != 'N' && hemisphere != 'E') return false;
+    *out_e7 = (int32_t)e7;
+    return true;
+}
+
+static void check_coord(const char *s, char hemisphere, bool ok, int32_t expected) {
+    int32_t got = 0, ref = 0;
+    bool parsed = nmea_parse_coord(s, (int)strlen(s), hemisphere, &got);
+    CHECK_EQ(parsed, ok);
+    CHECK_EQ(ref_parse_coord(s, (int)strlen(s), hemisphere, &ref), ok);
+    if (ok && parsed) {
+        CHECK_EQ(got, expected);
+        CHECK_EQ(ref, expected);
+    }
+}
+
+static void test_coord_vectors(void) {
+    check_coord("5321.6802", 'N', true, 533613367);
+    check_coord("00630.3372", 'W', true, -65056200);
+    check_coord("4807.038", 'N', true, 481173000);
+    check_coord("4807", 'N', true, 481166667);
+    check_coord("4807.", 'S', true, -481166667);
+    /* 0.000003' is exactly 0.5e-7 degrees: ties go away from zero. */
+    check_coord("0000.000003", 'N', true, 1);
+    check_coord("0000.000003", 'S', true, -1);
+    check_coord("0000.0000029", 'N', true, 0);
+    /* Only nine fractional digits count. */
+    check_coord("0000.0000000039", 'N', true, 0);
+    check_coord("18000.0000", 'E', true, 1800000000);
+    check_coord("17959.99999999", 'W', true, -1800000000);
+    check_coord("18000.0001", 'E', false, 0);
+    check_coord("4860.0000", 'N', false, 0);
+    check_coord("48.07", 'N', false, 0);
+    check_coord("123456.0", 'N', false, 0);
+    check_coord("4807.0a8", 'N', false, 0);
+    check_coord("4807.038", 'X', false, 0);
+    check_coord("", 'N', false, 0);
+}
+
+/* Random fields, well- and ill-formed, must agree with the reference bit for bit. */
+static void test_coord_random(void) {
+    uint64_t rng = 0x5851F42D4C957F2Dull;
+    static const char hemis[] = "NSEWX";
+    char s[32];
+    int mismatches = 0, accepted = 0;
+
+    for (int n = 0; n < 2000000; n++) {
+        int whole = 2 + bench_rand(&rng) % 5, frac = bench_rand(&rng) % 13, len = 0;
+        for (int i = 0; i < whole; i++) s[len++] = '0' + bench_rand(&rng) % 10;
+        if (whole >= 3 && (bench_rand(&rng) & 1)) s[len - 2] = '0' + bench_rand(&rng) % 6;
+        if (frac || (bench_rand(&rng) & 1)) s[len++] = '.';
+        for (int i = 0; i < frac; i++) s[len++] = '0' + bench_rand(&rng) % 10;
+        if (bench_rand(&rng) % 50 == 0) s[bench_rand(&rng) % len] = "-+ ,"[bench_rand(&rng) % 4];
+        char hemi = hemis[bench_rand(&rng) % (bench_rand(&rng) % 20 ? 4 : 5)];
+
+        int32_t got = 0, ref = 0;
+        bool ok = nmea_parse_coord(s, len, hemi, &got);
+        bool ref_ok = ref_parse_coord(s, len, hemi, &ref);
+        if (ok != ref_ok || (ok && got != ref)) {
+            if (mismatches++ < 5) {
+                fprintf(stderr, "coord %.*s %c: got %d/%ld, reference %d/%ld\n", len, s, hemi, ok, (long)got,
+                        ref_ok, (long)ref);
+            }
+        }
+        accepted += ok;
+    }
+    CHECK_EQ(mismatches, 0);
+    CHECK(accepted > 500000);
+}
+
+int main(void) {
+    test_coord_vectors();
+    test_coord_random();
+    return check_report("test_coords");
+}
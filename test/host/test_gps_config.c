@@ -0,0 +1,211 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "check.h"
+#include "gps_config.h"
+#include "nmea_samples.h"
+
+/*
+ * gps_config_negotiate against a scripted MTK-style module on a virtual
+ * clock. The module hears the host only when both sides use the same baud
+ * rate; otherwise its output reaches the host as line noise.
+ */
+typedef struct {
+    /* behaviour */
+    bool pmtk;                  /* answers PMTK commands at all */
+    uint32_t max_baud;          /* fastest PMTK251 rate it follows */
+    uint16_t min_interval_ms;   /* shortest PMTK220 it accepts */
+    bool dies_on_switch;        /* goes silent on any PMTK251 */
+
+    /* state */
+    uint32_t baud;              /* 0 = silent */
+    uint32_t link_baud;
+    uint32_t now_ms;
+    uint32_t next_fix_ms;
+    uint16_t interval_ms;
+    char out[512];
+    size_t out_len, out_pos;
+    char line[96];
+    size_t line_len;
+    int pmtk220_seen;
+} module_t;
+
+static void queue(module_t *m, const char *s) {
+    size_t n = strlen(s);
+    if (m->out_len + n <= sizeof(m->out)) {
+        memcpy(m->out + m->out_len, s, n);
+        m->out_len += n;
+    }
+}
+
+static void ack(module_t *m, int cmd, int flag) {
+    char body[32], line[48];
+    uint8_t sum = 0;
+    snprintf(body, sizeof(body), "PMTK001,%d,%d", cmd, flag);
+    for (const char *p = body; *p; p++) sum ^= (uint8_t)*p;
+    snprintf(line, sizeof(line), "$%s*%02X\r\n", body, sum);
+    queue(m, line);
+}
+
+static void handle_command(module_t *m, const char *line) {
+    unsigned cmd, arg;
+    if (!m->pmtk || sscanf(line, "$PMTK%3u", &cmd) != 1) return;
+    switch (cmd) {
+    case 314:
+        ack(m, 314, 3);
+        break;
+    case 251:
+        if (sscanf(line, "$PMTK251,%u", &arg) != 1) break;
+        if (m->dies_on_switch) m->baud = 0;
+        else if (arg <= m->max_baud) m->baud = arg;
+        break;
+    case 220:
+        if (sscanf(line, "$PMTK220,%u", &arg) != 1) break;
+        m->pmtk220_seen++;
+        if (arg >= m->min_interval_ms) {
+            m->interval_ms = arg;
+            ack(m, 220, 3);
+        } else {
+            ack(m, 220, 2);
+        }
+        break;
+    }
+}
+
+static void link_write(void *ctx, const char *data, size_t len) {
+    module_t *m = ctx;
+    if (m->link_baud != m->baud) return;
+    for (size_t i = 0; i < len; i++) {
+        if (m->line_len < sizeof(m->line) - 1) m->line[m->line_len++] = data[i];
+        if (data[i] == '\n') {
+            m->line[m->line_len] = '\0';
+            handle_command(m, m->line);
+            m->line_len = 0;
+        }
+    }
+}
+
+static int link_read(void *ctx, uint8_t *buf, size_t len, uint32_t timeout_ms) {
+    module_t *m = ctx;
+    if (m->out_pos == m->out_len) {
+        m->out_pos = m->out_len = 0;
+        if (m->baud && m->next_fix_ms <= m->now_ms + timeout_ms) {
+            if (m->next_fix_ms > m->now_ms) m->now_ms = m->next_fix_ms;
+            m->next_fix_ms += m->interval_ms;
+            queue(m, NMEA_GGA_FIX NMEA_RMC);
+        } else {
+            m->now_ms += timeout_ms;
+            return 0;
+        }
+    }
+    size_t n = m->out_len - m->out_pos;
+    if (n > len) n = len;
+    memcpy(buf, m->out + m->out_pos, n);
+    m->out_pos += n;
+    m->now_ms += 1;
+    if (m->link_baud != m->baud) memset(buf, 0xF0, n);
+    return (int)n;
+}
+
+static void link_set_baud(void *ctx, uint32_t baud) {
+    module_t *m = ctx;
+    m->link_baud = baud;
+    m->out_pos = m->out_len = 0;
+}
+
+static uint32_t link_now_ms(void *ctx) {
+    return ((module_t *)ctx)->now_ms;
+}
+
+static gps_config_result_t negotiate(module_t *m, bool *ok) {
+    gps_link_t link = {
+        .ctx = m,
+        .write = link_write,
+        .read = link_read,
+        .set_baud = link_set_baud,
+        .now_ms = link_now_ms,
+    };
+    gps_config_result_t out;
+    m->baud = m->link_baud = 9600;
+    m->interval_ms = 1000;
+    m->next_fix_ms = 300;
+    *ok = gps_config_negotiate(&link, 9600, &out);
+    /* Never leaves the host on a rate the module is not using. */
+    if (*ok) CHECK_EQ(m->link_baud, m->baud);
+    return out;
+}
+
+static void test_full_mtk(void) {
+    module_t m = { .pmtk = true, .max_baud = 115200, .min_interval_ms = 100 };
+    bool ok;
+    gps_config_result_t r = negotiate(&m, &ok);
+    CHECK(ok);
+    CHECK(r.output_acked);
+    CHECK_EQ(r.baud, 115200);
+    CHECK_EQ(r.fix_interval_ms, 100);
+    CHECK_EQ(r.baud_fallbacks, 0);
+    CHECK_EQ(r.rate_rejects, 0);
+}
+
+static void test_baud_fallback(void) {
+    module_t m = { .pmtk = true, .max_baud = 57600, .min_interval_ms = 100 };
+    bool ok;
+    gps_config_result_t r = negotiate(&m, &ok);
+    CHECK(ok);
+    CHECK_EQ(r.baud, 57600);
+    CHECK_EQ(r.baud_fallbacks, 1);
+    CHECK_EQ(r.fix_interval_ms, 100);
+}
+
+/* Stuck at 9600: 160 bytes per fix at 50% of 960 B/s allows 500 ms at best. */
+static void test_no_baud_switch(void) {
+    module_t m = { .pmtk = true, .max_baud = 9600, .min_interval_ms = 100 };
+    bool ok;
+    gps_config_result_t r = negotiate(&m, &ok);
+    CHECK(ok);
+    CHECK_EQ(r.baud, 9600);
+    CHECK_EQ(r.baud_fallbacks, 3);
+    CHECK_EQ(r.fix_interval_ms, 500);
+}
+
+static void test_rate_reject(void) {
+    module_t m = { .pmtk = true, .max_baud = 115200, .min_interval_ms = 200 };
+    bool ok;
+    gps_config_result_t r = negotiate(&m, &ok);
+    CHECK(ok);
+    CHECK_EQ(r.fix_interval_ms, 200);
+    CHECK_EQ(r.rate_rejects, 1);
+}
+
+static void test_not_pmtk(void) {
+    module_t m = { .pmtk = false };
+    bool ok;
+    gps_config_result_t r = negotiate(&m, &ok);
+    CHECK(ok);
+    CHECK(!r.output_acked);
+    CHECK_EQ(r.baud, 9600);
+    CHECK_EQ(r.fix_interval_ms, 1000);
+}
+
+/* Silent at the new rate and the old one: reported, and no PMTK220 goes out. */
+static void test_module_lost(void) {
+    module_t m = { .pmtk = true, .max_baud = 115200, .min_interval_ms = 100, .dies_on_switch = true };
+    bool ok;
+    gps_config_result_t r = negotiate(&m, &ok);
+    CHECK(!ok);
+    CHECK(r.module_lost);
+    CHECK_EQ(r.baud_fallbacks, 1);
+    CHECK_EQ(r.fix_interval_ms, 1000);
+    CHECK_EQ(m.pmtk220_seen, 0);
+    CHECK(m.now_ms < 2 * (GPS_CONFIG_ACK_MS + 2 * GPS_CONFIG_VERIFY_MS));
+}
+
+int main(void) {
+    test_full_mtk();
+    test_baud_fallback();
+    test_no_baud_switch();
+    test_rate_reject();
+    test_not_pmtk();
+    test_module_lost();
+    return check_report("test_gps_config");
+}
@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench.h"
+#include "check.h"
+#include "nmea.h"
+#include "nmea_samples.h"
+
+/*
+ * GPS time: nmea_parse_utc against timegm, and which RMC sentences
+ * nmea_rmc_utc lets through to the clock and the history stamps.
+ */
+static void test_utc(void) {
+    uint64_t rng = 0x14057B7EF767814Full;
+    char hms[32], dmy[32];
+    int64_t us;
+
+    CHECK(nmea_parse_utc("092750.000", 10, "280511", 6, &us));
+    CHECK_EQ(us, 1306574870000000ll);
+    CHECK(nmea_parse_utc("235959.25", 9, "311299", 6, &us));
+    CHECK_EQ(us, 4102444799250000ll);
+    CHECK(!nmea_parse_utc("246000", 6, "280511", 6, &us));
+    CHECK(!nmea_parse_utc("092750", 6, "001311", 6, &us));
+    CHECK(!nmea_parse_utc("092750,0", 8, "280511", 6, &us));
+
+    for (int n = 0; n < 200000; n++) {
+        struct tm tm = {
+            .tm_year = 100 + bench_rand(&rng) % 100,
+            .tm_mon = bench_rand(&rng) % 12,
+            .tm_mday = 1 + bench_rand(&rng) % 28,
+            .tm_hour = bench_rand(&rng) % 24,
+            .tm_min = bench_rand(&rng) % 60,
+            .tm_sec = bench_rand(&rng) % 60,
+        };
+        int ms = bench_rand(&rng) % 1000;
+        snprintf(hms, sizeof(hms), "%02d%02d%02d.%03d", tm.tm_hour, tm.tm_min, tm.tm_sec, ms);
+        snprintf(dmy, sizeof(dmy), "%02d%02d%02d", tm.tm_mday, tm.tm_mon + 1, tm.tm_year % 100);
+        int64_t expected = (int64_t)timegm(&tm) * 1000000 + ms * 1000;
+        if (!nmea_parse_utc(hms, 10, dmy, 6, &us) || us != expected) {
+            CHECK_EQ(us, expected);
+            break;
+        }
+    }
+}
+
+typedef struct {
+    int sentences;
+    bool accepted;
+    int64_t utc_us;
+} rmc_result_t;
+
+static void on_rmc(void *ctx, const nmea_fields_t *f) {
+    rmc_result_t *r = ctx;
+    r->sentences++;
+    r->accepted = nmea_rmc_utc(f, &r->utc_us);
+}
+
+static rmc_result_t feed_rmc(const char *sentence) {
+    nmea_reader_t rd;
+    rmc_result_t r = { 0 };
+    nmea_reader_init(&rd);
+    nmea_feed(&rd, (const uint8_t *)sentence, strlen(sentence), on_rmc, &r);
+    CHECK_EQ(r.sentences, 1);
+    return r;
+}
+
+static void test_rmc_acceptance(void) {
+    rmc_result_t r = feed_rmc(NMEA_RMC_2026);
+    CHECK(r.accepted);
+    CHECK_EQ(r.utc_us, 1789726530000000ll);
+
+    /* No fix yet: the module's 1980 default date must not reach the clock. */
+    CHECK(!feed_rmc(NMEA_RMC_VOID).accepted);
+    /* Some modules flag A while still on that default; the year catches it. */
+    CHECK(!feed_rmc(NMEA_RMC_EPOCH_ACTIVE).accepted);
+    /* A stale backup-RTC date from before any build of this firmware. */
+    CHECK(!feed_rmc(NMEA_RMC_2018).accepted);
+}
+
+int main(void) {
+    test_utc();
+    test_rmc_acceptance();
+    return check_report("test_nmea_utc");
+}
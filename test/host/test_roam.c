@@ -0,0 +1,39 @@
+#include <stdio.h>
+
+#include "check.h"
+#include "roam.h"
+
+static mac_key_t client_mac(uint32_t n) {
+    return 0x02AA00000000ull | n;
+}
+
+/* A table full of live clients still tracks a newcomer and reports its roam. */
+static void test_full_table_roam(void) {
+    mac_key_t ap1 = 0x02BB00000001ull, ap2 = 0x02BB00000002ull;
+    uint32_t ess = roam_ess_id("corp", 3);
+
+    for (uint32_t i = 0; i < 4 * ROAM_MAX_CLIENTS; i++) {
+        roam_observe(client_mac(i), ap1, ess, -60, 1000 + i);
+    }
+    roam_stats_t stats;
+    roam_get_stats(&stats);
+    CHECK_EQ(stats.tracked, ROAM_MAX_CLIENTS);
+    CHECK_EQ(stats.evicted, 3 * ROAM_MAX_CLIENTS);
+
+    mac_key_t walker = client_mac(0xFFFFF);
+    roam_observe(walker, ap1, ess, -70, 10000);
+    roam_observe(walker, ap2, ess, -50, 10200);
+
+    roam_event_t ev;
+    CHECK(roam_pop_event(&ev));
+    CHECK(mac_key_eq(ev.client, walker));
+    CHECK(mac_key_eq(ev.from, ap1));
+    CHECK(mac_key_eq(ev.to, ap2));
+    CHECK_EQ(ev.delta_ms, 200);
+    CHECK(!roam_pop_event(&ev));
+}
+
+int main(void) {
+    test_full_table_roam();
+    return check_report("test_roam");
+}